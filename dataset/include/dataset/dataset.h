@@ -0,0 +1,95 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <random>
+
+// Contiguous run of samples. Rows of inputs and targets are packed back to back,
+// so inputs + i * inputStride can be handed to NeuralNet::run directly.
+struct DatasetBatch
+{
+    const double* inputs;
+    const double* targets;
+    size_t size;
+    size_t inputStride;
+    size_t targetStride;
+};
+
+class MappedFile;
+
+// Samples of fixed-size input and target vectors, stored row by row.
+// Data is either owned, or memory-mapped read-only from a binary dataset file.
+//
+// File layout (native byte order): a 64-byte header holding the magic
+// "EVNNDS01", then the uint64 values rows, inputs, targets, inputs offset and
+// targets offset. The inputs and targets blocks each start on a 64-byte boundary.
+class Dataset
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    Dataset() : nInputs{0}, nTargets{0} {}
+    Dataset(size_t nInputs, size_t nTargets);
+
+    static Dataset load(const std::string& path);
+    void save(const std::string& path) const;
+
+    void addSample(const double* inputs, const double* targets);
+
+    size_t size() const { return nSamples; }
+    size_t getInputSize() const { return nInputs; }
+    size_t getTargetSize() const { return nTargets; }
+    bool isMapped() const { return mapping != nullptr; }
+
+    const double* getInputs(size_t i) const { return inputData() + i * nInputs; }
+    const double* getTargets(size_t i) const { return targetData() + i * nTargets; }
+
+    DatasetBatch getBatch(size_t first, size_t count) const;
+
+private:
+    const double* inputData() const { return mapping ? mappedInputs : inputs.data(); }
+    const double* targetData() const { return mapping ? mappedTargets : targets.data(); }
+
+    size_t nInputs;
+    size_t nTargets;
+    size_t nSamples{ 0 };
+    std::vector<double> inputs;
+    std::vector<double> targets;
+
+    std::shared_ptr<const MappedFile> mapping;
+    const double* mappedInputs{ nullptr };
+    const double* mappedTargets{ nullptr };
+};
+
+// Streams a CSV file with one sample per line, the first nInputs columns being
+// inputs and the rest targets, into the binary format read by Dataset::load.
+// Only a line at a time is held in memory. Returns the number of samples written.
+size_t convertCsvToDataset(const std::string& csvPath, const std::string& datasetPath, size_t nInputs);
+
+// A subset of sample indices into a Dataset, redrawn at random on request.
+// A batch size of 0 or one not smaller than the dataset selects all samples.
+class MiniBatch
+{
+public:
+    MiniBatch(const Dataset& dataset, size_t batchSize, unsigned int seed = 0);
+
+    void resample();
+    void selectAll();
+
+    const Dataset& getDataset() const { return *dataset; }
+    const std::vector<size_t>& getIndices() const { return indices; }
+    size_t size() const { return indices.size(); }
+
+private:
+    const Dataset* dataset;
+    size_t batchSize;
+    std::vector<size_t> permutation;
+    std::vector<size_t> indices;
+    std::default_random_engine engine;
+};
+
+#endif // DATASET_H
@@ -0,0 +1,326 @@
+#include "dataset/dataset.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DATASET_HAS_MMAP 1
+#endif
+
+namespace {
+
+const char fileMagic[8] = { 'E', 'V', 'N', 'N', 'D', 'S', '0', '1' };
+
+struct FileHeader
+{
+    char magic[8];
+    uint64_t rows;
+    uint64_t inputs;
+    uint64_t targets;
+    uint64_t inputsOffset;
+    uint64_t targetsOffset;
+    char padding[16];
+};
+static_assert(sizeof(FileHeader) == Dataset::alignment, "dataset header must fill one alignment unit");
+
+uint64_t alignUp(uint64_t n)
+{
+    return (n + Dataset::alignment - 1) / Dataset::alignment * Dataset::alignment;
+}
+
+FileHeader makeHeader(size_t rows, size_t nInputs, size_t nTargets)
+{
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.rows = rows;
+    header.inputs = nInputs;
+    header.targets = nTargets;
+    header.inputsOffset = sizeof(FileHeader);
+    header.targetsOffset = alignUp(header.inputsOffset + rows * nInputs * sizeof(double));
+    return header;
+}
+
+// Whether rows of columns doubles from offset fit in size bytes, without overflowing
+bool fitsIn(uint64_t offset, uint64_t rows, uint64_t columns, uint64_t size)
+{
+    if(offset > size) {
+        return false;
+    }
+    const auto available = (size - offset) / sizeof(double);
+    return columns == 0 || (columns <= available && rows <= available / columns);
+}
+
+void writePadding(std::ostream& os, uint64_t from, uint64_t to)
+{
+    static const char zeros[Dataset::alignment] = {};
+    os.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+}
+
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#ifdef DATASET_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            throw std::runtime_error("cannot open dataset " + path);
+        }
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat dataset " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if(length > 0) {
+            void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map dataset " + path);
+            }
+            ::madvise(addr, length, MADV_SEQUENTIAL);
+            base = static_cast<const char*>(addr);
+        }
+        ::close(fd);
+#else
+        std::ifstream is(path, std::ios::binary | std::ios::ate);
+        if(!is) {
+            throw std::runtime_error("cannot open dataset " + path);
+        }
+        length = static_cast<size_t>(is.tellg());
+        buffer.resize((length + sizeof(double) - 1) / sizeof(double));
+        is.seekg(0);
+        is.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(length));
+        base = reinterpret_cast<const char*>(buffer.data());
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef DATASET_HAS_MMAP
+        if(base) {
+            ::munmap(const_cast<char*>(base), length);
+        }
+#endif
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const char* base{ nullptr };
+    size_t length{ 0 };
+#ifndef DATASET_HAS_MMAP
+    std::vector<double> buffer;
+#endif
+};
+
+Dataset::Dataset(size_t nInputs_, size_t nTargets_)
+    : nInputs{ nInputs_ },
+      nTargets{ nTargets_ }
+{
+}
+
+Dataset Dataset::load(const std::string& path)
+{
+    auto mapping = std::make_shared<const MappedFile>(path);
+
+    FileHeader header;
+    if(mapping->size() < sizeof(header)) {
+        throw std::runtime_error("dataset file too short: " + path);
+    }
+    std::memcpy(&header, mapping->data(), sizeof(header));
+    if(std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0) {
+        throw std::runtime_error("not a dataset file: " + path);
+    }
+    if(header.inputsOffset % alignment != 0 || header.targetsOffset % alignment != 0
+       || !fitsIn(header.inputsOffset, header.rows, header.inputs, mapping->size())
+       || !fitsIn(header.targetsOffset, header.rows, header.targets, mapping->size())) {
+        throw std::runtime_error("corrupt dataset file: " + path);
+    }
+
+    Dataset ds(header.inputs, header.targets);
+    ds.nSamples = header.rows;
+    ds.mappedInputs = reinterpret_cast<const double*>(mapping->data() + header.inputsOffset);
+    ds.mappedTargets = reinterpret_cast<const double*>(mapping->data() + header.targetsOffset);
+    ds.mapping = std::move(mapping);
+    return ds;
+}
+
+void Dataset::save(const std::string& path) const
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if(!os) {
+        throw std::runtime_error("cannot create dataset " + path);
+    }
+
+    const auto header = makeHeader(nSamples, nInputs, nTargets);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const auto inputBytes = nSamples * nInputs * sizeof(double);
+    os.write(reinterpret_cast<const char*>(inputData()), static_cast<std::streamsize>(inputBytes));
+    writePadding(os, header.inputsOffset + inputBytes, header.targetsOffset);
+    os.write(reinterpret_cast<const char*>(targetData()),
+             static_cast<std::streamsize>(nSamples * nTargets * sizeof(double)));
+
+    if(!os) {
+        throw std::runtime_error("error writing dataset " + path);
+    }
+}
+
+void Dataset::addSample(const double* in, const double* tg)
+{
+    assert(!mapping);
+    inputs.insert(inputs.end(), in, in + nInputs);
+    targets.insert(targets.end(), tg, tg + nTargets);
+    ++nSamples;
+}
+
+DatasetBatch Dataset::getBatch(size_t first, size_t count) const
+{
+    assert(first <= nSamples);
+    count = std::min(count, nSamples - first);
+    return DatasetBatch{ getInputs(first), getTargets(first), count, nInputs, nTargets };
+}
+
+size_t convertCsvToDataset(const std::string& csvPath, const std::string& datasetPath, size_t nInputs)
+{
+    std::ifstream csv(csvPath);
+    if(!csv) {
+        throw std::runtime_error("cannot open CSV " + csvPath);
+    }
+
+    // Inputs go straight to the output file; targets are spooled to a side
+    // file and appended once the number of rows, and so their offset, is known
+    std::ofstream os(datasetPath, std::ios::binary | std::ios::trunc);
+    const auto spoolPath = datasetPath + ".targets.tmp";
+    std::fstream spool(spoolPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if(!os || !spool) {
+        throw std::runtime_error("cannot create dataset " + datasetPath);
+    }
+
+    const FileHeader placeholder{};
+    os.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+
+    size_t nColumns = 0;
+    size_t rows = 0;
+    std::string line;
+    std::vector<double> values;
+    while(std::getline(csv, line)) {
+        if(line.empty() || line == "\r") {
+            continue;
+        }
+
+        values.clear();
+        const char* p = line.c_str();
+        bool ok = true;
+        while(*p) {
+            char* end = nullptr;
+            values.push_back(std::strtod(p, &end));
+            if(end == p) {
+                ok = false;
+                break;
+            }
+            p = end;
+            while(*p == ' ' || *p == '\t' || *p == '\r') {
+                ++p;
+            }
+            if(*p == ',') {
+                ++p;
+            }
+        }
+
+        if(!ok) {
+            // A header line is allowed before the first sample
+            if(rows == 0 && nColumns == 0) {
+                continue;
+            }
+            throw std::runtime_error("bad CSV line " + std::to_string(rows + 1) + " in " + csvPath);
+        }
+        if(nColumns == 0) {
+            nColumns = values.size();
+            if(nColumns <= nInputs) {
+                throw std::runtime_error("CSV has no target columns: " + csvPath);
+            }
+        }
+        else if(values.size() != nColumns) {
+            throw std::runtime_error("inconsistent column count in " + csvPath);
+        }
+
+        os.write(reinterpret_cast<const char*>(values.data()),
+                 static_cast<std::streamsize>(nInputs * sizeof(double)));
+        spool.write(reinterpret_cast<const char*>(values.data() + nInputs),
+                    static_cast<std::streamsize>((nColumns - nInputs) * sizeof(double)));
+        ++rows;
+    }
+
+    const auto nTargets = nColumns ? nColumns - nInputs : 0;
+    const auto header = makeHeader(rows, nInputs, nTargets);
+    writePadding(os, header.inputsOffset + rows * nInputs * sizeof(double), header.targetsOffset);
+
+    spool.seekg(0);
+    std::vector<char> chunk(1 << 16);
+    while(spool.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || spool.gcount() > 0) {
+        os.write(chunk.data(), spool.gcount());
+    }
+    spool.close();
+    std::remove(spoolPath.c_str());
+
+    os.seekp(0);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!os) {
+        throw std::runtime_error("error writing dataset " + datasetPath);
+    }
+    return rows;
+}
+
+MiniBatch::MiniBatch(const Dataset& dataset_, size_t batchSize_, unsigned int seed)
+    : dataset{ &dataset_ },
+      batchSize{ batchSize_ },
+      engine{ seed }
+{
+    permutation.resize(dataset->size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    selectAll();
+}
+
+void MiniBatch::resample()
+{
+    const auto nSamples = permutation.size();
+    if(batchSize == 0 || batchSize >= nSamples) {
+        selectAll();
+        return;
+    }
+
+    // Partial Fisher-Yates shuffle: only the first batchSize entries are drawn
+    for(size_t i = 0; i < batchSize; ++i) {
+        std::uniform_int_distribution<size_t> dis(i, nSamples - 1);
+        std::swap(permutation[i], permutation[dis(engine)]);
+    }
+
+    // Sorted so that the batch is walked through the dataset in memory order
+    indices.assign(permutation.cbegin(), permutation.cbegin() + batchSize);
+    std::sort(indices.begin(), indices.end());
+}
+
+void MiniBatch::selectAll()
+{
+    indices.resize(dataset->size());
+    std::iota(indices.begin(), indices.end(), 0);
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+
+#include "dataset/dataset.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+
+Dataset makeDataset(size_t nSamples)
+{
+    Dataset ds(2, 1);
+    for(size_t i = 0; i < nSamples; ++i) {
+        const double inputs[2] = { static_cast<double>(i), -static_cast<double>(i) };
+        const double target = 10.0 * i;
+        ds.addSample(inputs, &target);
+    }
+    return ds;
+}
+
+}
+
+TEST_CASE( "Samples are stored row by row", "[dataset]" ) {
+    const auto ds = makeDataset(3);
+    REQUIRE(ds.size() == 3);
+    REQUIRE(ds.getInputSize() == 2);
+    REQUIRE(ds.getTargetSize() == 1);
+    REQUIRE(ds.getInputs(2)[0] == 2);
+    REQUIRE(ds.getInputs(2)[1] == -2);
+    REQUIRE(ds.getTargets(1)[0] == 10);
+}
+
+TEST_CASE( "Mini batch starts with all samples selected", "[dataset]" ) {
+    const auto ds = makeDataset(10);
+    MiniBatch batch(ds, 4);
+    REQUIRE(batch.size() == 10);
+}
+
+TEST_CASE( "Resampled mini batch holds distinct sorted indices", "[dataset]" ) {
+    const auto ds = makeDataset(100);
+    MiniBatch batch(ds, 10, 1234);
+    for(int k = 0; k < 20; ++k) {
+        batch.resample();
+        const auto& indices = batch.getIndices();
+        REQUIRE(indices.size() == 10);
+        REQUIRE(std::is_sorted(indices.cbegin(), indices.cend()));
+        REQUIRE(std::adjacent_find(indices.cbegin(), indices.cend()) == indices.cend());
+        REQUIRE(indices.back() < 100);
+    }
+    batch.selectAll();
+    REQUIRE(batch.size() == 100);
+}
+
+TEST_CASE( "Batch size not smaller than dataset selects all samples", "[dataset]" ) {
+    const auto ds = makeDataset(5);
+    MiniBatch batch(ds, 5);
+    batch.resample();
+    REQUIRE(batch.size() == 5);
+    MiniBatch unbounded(ds, 0);
+    unbounded.resample();
+    REQUIRE(unbounded.size() == 5);
+}
+
+TEST_CASE( "Batch views are contiguous runs of rows", "[dataset]" ) {
+    const auto ds = makeDataset(10);
+    const auto batch = ds.getBatch(8, 5);
+    REQUIRE(batch.size == 2);
+    REQUIRE(batch.inputs[batch.inputStride * 1] == 9);
+    REQUIRE(batch.targets[batch.targetStride * 1] == 90);
+}
+
+TEST_CASE( "Saved dataset is memory-mapped back unchanged", "[dataset]" ) {
+    const auto ds = makeDataset(7);
+    const std::string path = "dataset_roundtrip_test.bin";
+    ds.save(path);
+
+    const auto loaded = Dataset::load(path);
+    REQUIRE(loaded.isMapped());
+    REQUIRE(loaded.size() == 7);
+    REQUIRE(loaded.getInputSize() == 2);
+    REQUIRE(loaded.getTargetSize() == 1);
+    for(size_t i = 0; i < ds.size(); ++i) {
+        REQUIRE(loaded.getInputs(i)[0] == ds.getInputs(i)[0]);
+        REQUIRE(loaded.getInputs(i)[1] == ds.getInputs(i)[1]);
+        REQUIRE(loaded.getTargets(i)[0] == ds.getTargets(i)[0]);
+    }
+
+    const auto batch = loaded.getBatch(0, loaded.size());
+    REQUIRE(reinterpret_cast<uintptr_t>(batch.inputs) % Dataset::alignment == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(batch.targets) % Dataset::alignment == 0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE( "CSV is converted into the binary layout", "[dataset]" ) {
+    const std::string csvPath = "dataset_convert_test.csv";
+    const std::string binPath = "dataset_convert_test.bin";
+    {
+        std::ofstream csv(csvPath);
+        csv << "x,y,target\n"
+            << "1.5, 2, 3\n"
+            << "-4,5e-1,6\r\n"
+            << "\n"
+            << "7,8,9\n";
+    }
+
+    REQUIRE(convertCsvToDataset(csvPath, binPath, 2) == 3);
+    const auto ds = Dataset::load(binPath);
+    REQUIRE(ds.size() == 3);
+    REQUIRE(ds.getInputSize() == 2);
+    REQUIRE(ds.getTargetSize() == 1);
+    REQUIRE(ds.getInputs(0)[0] == 1.5);
+    REQUIRE(ds.getInputs(1)[1] == 0.5);
+    REQUIRE(ds.getTargets(1)[0] == 6);
+    REQUIRE(ds.getTargets(2)[0] == 9);
+    std::remove(csvPath.c_str());
+    std::remove(binPath.c_str());
+}
+
+TEST_CASE( "Loading a file that is not a dataset throws", "[dataset]" ) {
+    const std::string path = "dataset_bad_test.bin";
+    {
+        std::ofstream os(path);
+        os << "this is not a dataset file, but it is long enough to hold a header......";
+    }
+    REQUIRE_THROWS(Dataset::load(path));
+    std::remove(path.c_str());
+}
+
+TEST_CASE( "Loading a header whose sizes overflow throws", "[dataset]" ) {
+    const std::string path = "dataset_overflow_test.bin";
+    {
+        // 2^58 rows of 8 inputs and of 8 targets wrap around to 0 bytes in 64 bits
+        const uint64_t fields[5] = { uint64_t{1} << 58, 8, 8, 64, 64 };
+        const char padding[16] = {};
+        std::ofstream os(path, std::ios::binary);
+        os.write("EVNNDS01", 8);
+        os.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+        os.write(padding, sizeof(padding));
+        os.write(padding, sizeof(padding));
+    }
+    REQUIRE_THROWS(Dataset::load(path));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,25 @@
+#include "dataset/dataset.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char **argv)
+{
+    if(argc != 4) {
+        std::cerr << "usage: " << argv[0] << " <input.csv> <output.dataset> <number of input columns>\n";
+        return 1;
+    }
+
+    try {
+        const auto nInputs = std::stoul(argv[3]);
+        const auto rows = convertCsvToDataset(argv[1], argv[2], nInputs);
+        std::cout << "wrote " << rows << " samples to " << argv[2] << "\n";
+    }
+    catch(const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -4,13 +4,33 @@
 #include <random>
 #include <iomanip>
 #include <cassert>
+#include <fstream>
 
 #include "neuralnet/neuralnet.h"
+#include "neuralnet/jit.h"
+#include "neuralnet/quantized.h"
+#include "neuralnet/interleaved.h"
+#include "neuralnet/sparse.h"
+#include "neuralnet/graphgenome.h"
+#include "neuralnet/codegen.h"
 #include "population/population.h"
+#include "population/staticpopulation.h"
+#include "population/cmaes.h"
+#include "population/openaies.h"
+#include "population/mutation.h"
+#include "population/crossover.h"
+#include "population/seedgenome.h"
+#include "population/novelty.h"
+#include "population/multiobjective.h"
+#include "population/sweep.h"
+#include "population/metricslog.h"
+#include "dataset/dataset.h"
+#include "tracing/trace.h"
 
 #include "htmlanim_shapes.hpp"
 
-std::default_random_engine generator;
+// Per thread, so that concurrent sweep runs each have their own seeded stream
+thread_local std::default_random_engine generator;
 
 double getGaussianRand(double mean, double stddev)
 {
@@ -52,48 +72,285 @@ double targetFunction(double x)
     // return x == 0 ? 0 : (0.3 * x * sin(30 / x));
 }
 
-class NnIndividual : public Individual
+Dataset makeTargetDataset()
+{
+    Dataset dataset(1, 1);
+    // Map: [-PI,PI] -> [-1,1]
+    for(int i = 0; i < sections + 1; ++i) {
+        const double x = -M_PI + 2 * M_PI / sections * i;
+        const double inputs = x / M_PI;
+        const auto target = targetFunction(x);
+        dataset.addSample(&inputs, &target);
+    }
+    return dataset;
+}
+
+enum class MutationMode { Dense, LayerWise, Sparse };
+
+// Layer-wise mutation perturbs a single random layer per step, sparse mutation
+// about sparseMutationCount random weights. Individuals then keep their hidden
+// activations per sample, and evaluation resumes the forward pass at the first
+// changed layer.
+MutationMode mutationMode = MutationMode::Dense;
+const double sparseMutationCount = 4;
+
+// Compact individuals store their weights as the parent lineage plus mutation
+// seeds and only materialize them for evaluation, through a cache of recently
+// used genomes. This trades recomputation for memory; it implies dense mutation
+// and only works with the built-in truncation selection.
+const bool compactGenomes = false;
+GenomeCache genomeCache(64);
+
+// Run the forward pass through code compiled for the topology at startup
+const bool useJit = false;
+JitCompiler jitCompiler;
+
+// Evaluate on threads pinned to each NUMA node, with every node's share of the
+// population allocated locally. Needs the polymorphic Population.
+const bool numaEvaluation = false;
+
+// Select by novelty of the outputs on all target samples, blended with fitness
+// by noveltyWeight (1 is pure novelty search). Needs the polymorphic Population.
+const bool noveltySearch = false;
+const double noveltyWeight = 0.5;
+
+// Rank by NSGA-II on the error and the mean absolute weight, trading accuracy for
+// smaller weights. Needs the polymorphic Population.
+const bool multiObjective = false;
+
+// Predict the fitness of mutated individuals from their parent's fitness and
+// mutation step size, and evaluate only the best predicted surrogateFraction.
+// Needs the polymorphic Population.
+const bool useSurrogate = false;
+const double surrogateFraction = 0.5;
+
+// Fraction of connection weights kept: networks start magnitude-pruned to it and
+// mutation and refinement only change the surviving weights. Evaluation takes the
+// sparse path below defaultSparseDensity. 1 keeps networks dense; compact genomes
+// always are.
+const double weightDensity = 1.0;
+
+// Share of offspring recombined from their parent and a random mate by
+// crossoverMode before mutation; the rest copy their parent. Layer swap exchanges
+// whole layers. Compact genomes and pruned nets always copy.
+enum class CrossoverMode { Uniform, Blend, LayerSwap, Sbx };
+const CrossoverMode crossoverMode = CrossoverMode::Uniform;
+const double crossoverRate = 0;
+const SbxCrossover sbxCrossover(15);
+
+// Evolve graph genomes that grow from a direct input-output connection instead of
+// the fixed layered nets, see topologyEvolution. Each mutation adds a hidden node
+// or a connection with these probabilities.
+const bool evolveTopology = false;
+const double addNodeRate = 0.03;
+const double addConnectionRate = 0.05;
+
+// Run sweep1 instead of a single evolution
+const bool runSweep = false;
+
+class NnIndividual final : public Individual
 {
 public:
-    NnIndividual() : nn(1, {8, 8, 1}, true), stddev{ 0.25 }
+    explicit NnIndividual(const MiniBatch& samples_, const std::vector<size_t>& layerSizes = {8, 8, 1},
+                          double initialStddev = 0.25)
+        : nn(1, layerSizes, true), stddev{ initialStddev }, samples{ &samples_ }
     {
         auto& weights = nn.getWeights();
+        if(compactGenomes) {
+            // The same standard normal start as below, as a seeded mutation of an
+            // all-zero base that takes no storage. Chains rebase every 16 to 32
+            // mutations, which keeps replays short.
+            genome = SeedGenome(weights.size(), 32);
+            genome.mutate(SeedMutation{ generator(), 1.0 });
+            weights.clear();
+            weights.shrink_to_fit();
+            return;
+        }
+
         for(auto& w : weights) {
             w = getGaussianRand(0, 1.0);
         }
+        if(weightDensity < 1) {
+            pruneToDensity(nn, weightDensity);
+        }
     }
 
     ~NnIndividual() override
     {
     }
 
+    // Mean squared error over the currently selected samples, so that
+    // fitnesses from batches of different sizes stay comparable
     void evaluate() override
     {
-        std::vector<double> outputs;
+        TRACE_SCOPE("evaluateIndividual");
+        if(!compactGenomes) {
+            evaluateWeights();
+            recordDescriptors();
+            return;
+        }
 
-        // Map: [-PI,PI] -> [-1,1]
-        for(int i = 0; i < sections + 1; ++i) {
-            const double x = -M_PI + 2 * M_PI / sections * i;
-            const auto expect = targetFunction(x);
+        // One buffer per evaluating thread; the genome cache locks itself
+        thread_local std::vector<double> materialized;
+        genome.materialize(materialized, &genomeCache);
+        nn.getWeights().swap(materialized);
+        evaluateWeights();
+        recordDescriptors();
+        nn.getWeights().swap(materialized);
+    }
 
-            double inputs = x / M_PI;
+    // Batches of plain dense individuals run InterleavedNets::maxLanes nets per pass
+    // over the samples; the other modes keep per-individual state or sparse weights
+    // and go one by one
+    static void evaluateBatch(NnIndividual* const* batch, size_t n)
+    {
+        if(compactGenomes || useJit || mutationMode != MutationMode::Dense || weightDensity < 1) {
+            for(size_t i = 0; i < n; ++i) {
+                batch[i]->evaluate();
+            }
+            return;
+        }
 
-            const auto resultIdx = nn.run(&inputs, outputs);
+        thread_local InterleavedNets lanes;
+        const NeuralNet* nets[InterleavedNets::maxLanes];
+        for(size_t first = 0; first < n; first += InterleavedNets::maxLanes) {
+            const auto count = std::min(n - first, InterleavedNets::maxLanes);
+            const auto samples = batch[first]->samples;
+            for(size_t i = 0; i < count; ++i) {
+                assert(batch[first + i]->samples == samples);
+                nets[i] = &batch[first + i]->nn;
+            }
+            lanes.load(nets, count);
 
-            const auto actual = outputs[resultIdx];
+            const auto& dataset = samples->getDataset();
+            double errors[InterleavedNets::maxLanes] = {};
+            for(const auto idx : samples->getIndices()) {
+                const auto actual = lanes.run(dataset.getInputs(idx));
+                const auto expect = *dataset.getTargets(idx);
+                for(size_t i = 0; i < count; ++i) {
+                    const auto diff = actual[i] - expect;
+                    errors[i] += diff * diff;
+                }
+            }
+            for(size_t i = 0; i < count; ++i) {
+                batch[first + i]->fitness += errors[i];
+                batch[first + i]->fitness /= static_cast<double>(samples->size());
+                batch[first + i]->recordDescriptors();
+            }
+        }
+    }
+
+    void evaluateBatch(Individual* const* batch, size_t n) override
+    {
+        thread_local std::vector<NnIndividual*> nnBatch;
+        nnBatch.clear();
+        for(size_t i = 0; i < n; ++i) {
+            const auto nnIdv = dynamic_cast<NnIndividual*>(batch[i]);
+            if(!nnIdv) {
+                Individual::evaluateBatch(batch, n);
+                return;
+            }
+            nnBatch.push_back(nnIdv);
+        }
+        evaluateBatch(nnBatch.data(), n);
+    }
+
+    // Loads the weights of a compact genome into nn, e.g. for drawing
+    void materialize()
+    {
+        if(compactGenomes) {
+            genome.materialize(nn.getWeights(), &genomeCache);
+        }
+    }
+
+    // A few steps of gradient descent on the mean squared error of the current
+    // samples, kept only if they actually lowered it. Compact genomes can only
+    // change by seeded mutations and are left alone.
+    void refine() override
+    {
+        if(compactGenomes) {
+            return;
+        }
+
+        const int steps = 10;
+        const double learningRate = 0.05;
+
+        const auto& dataset = samples->getDataset();
+        const auto nSamples = static_cast<double>(samples->size());
+        auto& weights = nn.getWeights();
+        const auto original = weights;
 
-            auto diff = fabs(actual - expect);
-            const auto diffsq = diff * diff;
-            fitness += diffsq;
+        double startLoss = -1;
+        double loss = 0;
+        for(int step = 0; step <= steps; ++step) {
+            std::fill(gradients.begin(), gradients.end(), 0.0);
+            loss = 0;
+            for(const auto idx : samples->getIndices()) {
+                loss += nn.backprop(dataset.getInputs(idx), dataset.getTargets(idx), gradients, scratch);
+            }
+            if(startLoss < 0) {
+                startLoss = loss;
+            }
+            if(step == steps) {
+                break;
+            }
+            for(size_t i = 0; i < weights.size(); ++i) {
+                if(!isPruned(original[i])) {
+                    weights[i] -= learningRate * 2 * gradients[i] / nSamples;
+                }
+            }
+        }
+
+        if(loss > startLoss) {
+            weights = original;
+        }
+        else {
+            invalidateCache(0);
         }
     }
 
     void mutate() override
     {
         auto& weights = nn.getWeights();
-        for(auto& w : weights) {
-            const auto variation = getGaussianRand(0, stddev);
-            w += variation;
+        lastMutation.clear();
+        if(compactGenomes) {
+            genome.mutate(SeedMutation{ generator(), stddev }, &genomeCache);
+        }
+        else if(mutationMode == MutationMode::Sparse) {
+            const auto p = std::min(1.0, sparseMutationCount / weights.size());
+            sampleSparseIndices(weights.size(), p, generator, mutatedIndices);
+            for(const auto i : mutatedIndices) {
+                if(isPruned(weights[i])) {
+                    continue;
+                }
+                const auto variation = getGaussianRand(0, stddev);
+                weights[i] += variation;
+                lastMutation.push_back(GenomeDelta{ i, variation });
+            }
+            if(!mutatedIndices.empty()) {
+                invalidateCache(layerOfWeight(mutatedIndices.front()));
+            }
+        }
+        else if(mutationMode == MutationMode::LayerWise) {
+            const auto nLayers = nn.getLayerSizes().size();
+            std::uniform_int_distribution<size_t> pick(0, nLayers - 1);
+            const auto layer = pick(generator);
+            const auto end = layer + 1 < nLayers ? nn.getLayerWeightsBegin(layer + 1) : weights.size();
+            for(size_t i = nn.getLayerWeightsBegin(layer); i < end; ++i) {
+                if(!isPruned(weights[i])) {
+                    weights[i] += getGaussianRand(0, stddev);
+                }
+            }
+            invalidateCache(layer);
+        }
+        else {
+            for(auto& w : weights) {
+                if(isPruned(w)) {
+                    continue;
+                }
+                const auto variation = getGaussianRand(0, stddev);
+                w += variation;
+            }
         }
         std::uniform_real_distribution<> dis(0.8, 1.2);
         stddev *= dis(generator);
@@ -102,22 +359,303 @@ public:
 
     void mutateFrom(const Individual* other) override
     {
-        const auto otherNn = dynamic_cast<const NnIndividual*>(other);
-        assert(this->nn.getInputs() == otherNn->nn.getInputs());
-        assert(this->nn.getLayerSizes() == otherNn->nn.getLayerSizes());
+        mutateFrom(*dynamic_cast<const NnIndividual*>(other));
+    }
+
+    void mutateFrom(const NnIndividual& other)
+    {
+        assert(this->nn.getInputs() == other.nn.getInputs());
+        assert(this->nn.getLayerSizes() == other.nn.getLayerSizes());
+
+        stddev = other.stddev;
+        nn = other.nn;
+        genome = other.genome;
+        trace = other.trace;
+        cleanLayers = other.cleanLayers;
+        mutate();
+    }
+
+    bool crossoverFrom(const Individual* a, const Individual* b) override
+    {
+        const auto nnA = dynamic_cast<const NnIndividual*>(a);
+        const auto nnB = dynamic_cast<const NnIndividual*>(b);
+        return nnA && nnB && crossoverFrom(*nnA, *nnB);
+    }
+
+    // Writes the recombined weights straight into this individual's own buffer
+    bool crossoverFrom(const NnIndividual& a, const NnIndividual& b)
+    {
+        if(compactGenomes || weightDensity < 1) {
+            return false;
+        }
+        assert(a.nn.getLayerSizes() == nn.getLayerSizes() && b.nn.getLayerSizes() == nn.getLayerSizes());
 
-        stddev = otherNn->stddev;
-        nn = otherNn->nn;
+        const auto& weightsA = a.nn.getWeights();
+        const auto& weightsB = b.nn.getWeights();
+        auto& weights = nn.getWeights();
+        const auto n = weights.size();
+        const auto seed = generator();
+        switch(crossoverMode) {
+        case CrossoverMode::Uniform:
+            uniformCrossover(weightsA.data(), weightsB.data(), weights.data(), n, seed);
+            break;
+        case CrossoverMode::Blend:
+            blendCrossover(weightsA.data(), weightsB.data(), weights.data(), n, 0.5);
+            break;
+        case CrossoverMode::LayerSwap: {
+            const auto nLayers = nn.getLayerSizes().size();
+            thread_local std::vector<size_t> bounds;
+            bounds.clear();
+            for(size_t layer = 0; layer < nLayers; ++layer) {
+                bounds.push_back(nn.getLayerWeightsBegin(layer));
+            }
+            bounds.push_back(n);
+            segmentCrossover(weightsA.data(), weightsB.data(), weights.data(), bounds.data(), nLayers, seed);
+            break;
+        }
+        case CrossoverMode::Sbx:
+            sbxCrossover(weightsA.data(), weightsB.data(), weights.data(), n, seed);
+            break;
+        }
+        stddev = std::sqrt(a.stddev * b.stddev);
+        invalidateCache(0);
         mutate();
+        return true;
+    }
+
+    const std::vector<double>* getBehavior() const override
+    {
+        return noveltySearch ? &behavior : nullptr;
+    }
+
+    const std::vector<double>* getObjectives() const override
+    {
+        return multiObjective ? &objectives : nullptr;
+    }
+
+    void getFeatures(std::vector<double>& features) const override
+    {
+        features.push_back(stddev);
+    }
+
+    std::unique_ptr<Individual> clone() const override
+    {
+        return std::make_unique<NnIndividual>(*this);
     }
 
     void dump(std::ostream& os) const override
     {
+        if(nn.getWeights().empty()) {
+            os << "genome " << genome.getId() << " depth " << genome.getDepth();
+            return;
+        }
         os << nn.getWeights()[0] << "/" << nn.getWeights()[1] << "/" << nn.getWeights()[2];
     }
 
+    // Callers may change any weight through the genome
+    std::vector<double>* getGenome() override
+    {
+        if(compactGenomes) {
+            return nullptr;
+        }
+        invalidateCache(0);
+        return &nn.getWeights();
+    }
+
+    // Weights changed by the last sparse mutation, relative to the parent
+    const std::vector<GenomeDelta>& getLastMutation() const { return lastMutation; }
+
     NeuralNet nn;
     double stddev{0};
+
+private:
+    // Weights pruned away stay zero; biases are practically never exactly zero
+    static bool isPruned(double w)
+    {
+        return weightDensity < 1 && w == 0;
+    }
+
+    // The behavior is the outputs on every sample of the dataset, the same probes
+    // for all individuals. Both need the weights, so are taken right after evaluation.
+    void recordDescriptors()
+    {
+        if(noveltySearch) {
+            const auto& dataset = samples->getDataset();
+            auto& ws = NeuralNet::Workspace::local(nn);
+            behavior.resize(dataset.size());
+            for(size_t i = 0; i < dataset.size(); ++i) {
+                behavior[i] = *nn.run(dataset.getInputs(i), ws);
+            }
+        }
+        if(multiObjective) {
+            double sumAbs = 0;
+            for(const auto w : nn.getWeights()) {
+                sumAbs += std::fabs(w);
+            }
+            objectives = { fitness, sumAbs / nn.getWeights().size() };
+        }
+    }
+
+    void evaluateWeights()
+    {
+        auto& ws = NeuralNet::Workspace::local(nn);
+        const auto outputs = ws.getOutputs();
+
+        const auto& dataset = samples->getDataset();
+        const bool useCache = mutationMode != MutationMode::Dense && !compactGenomes;
+        const auto traceSize = nn.getTraceSize();
+        const auto outputLayer = nn.getLayerSizes().size() - 1;
+        const auto forward = useJit ? jitCompiler.get(nn) : nullptr;
+        thread_local SparseNet sparse;
+        thread_local std::vector<double> sparseScratch;
+        const bool useSparse = !useCache && !forward && weightDensity < 1 && preferSparse(nn);
+        if(useSparse) {
+            sparse.assign(nn);
+        }
+        if(useCache && trace.size() != dataset.size() * traceSize) {
+            trace.assign(dataset.size() * traceSize, 0);
+            cleanLayers.assign(dataset.size(), 0);
+        }
+
+        for(const auto idx : samples->getIndices()) {
+            double actual;
+            if(useCache) {
+                auto& clean = cleanLayers[idx];
+                nn.run(dataset.getInputs(idx), outputs, &trace[idx * traceSize], std::min(clean, outputLayer));
+                clean = outputLayer;
+                actual = outputs[0];
+            }
+            else if(forward) {
+                forward(nn.getWeights().data(), dataset.getInputs(idx), outputs);
+                actual = outputs[0];
+            }
+            else if(useSparse) {
+                sparse.run(dataset.getInputs(idx), outputs, sparseScratch);
+                actual = outputs[0];
+            }
+            else {
+                actual = *nn.run(dataset.getInputs(idx), ws);
+            }
+            const auto expect = *dataset.getTargets(idx);
+
+            const auto diff = actual - expect;
+            fitness += diff * diff;
+        }
+        fitness /= static_cast<double>(samples->size());
+    }
+
+    const MiniBatch* samples;
+    SeedGenome genome;
+    std::vector<double> gradients;
+    std::vector<double> scratch;
+
+    // Hidden activations per dataset sample, and for each sample the number of
+    // leading layers whose cached activations are still valid
+    std::vector<double> trace;
+    std::vector<size_t> cleanLayers;
+
+    std::vector<size_t> mutatedIndices;
+    std::vector<GenomeDelta> lastMutation;
+
+    // Outputs on all dataset samples, for novelty search
+    std::vector<double> behavior;
+    std::vector<double> objectives;
+
+    size_t layerOfWeight(size_t index) const
+    {
+        size_t layer = 0;
+        while(layer + 1 < nn.getLayerSizes().size() && nn.getLayerWeightsBegin(layer + 1) <= index) {
+            ++layer;
+        }
+        return layer;
+    }
+
+    void invalidateCache(size_t firstChangedLayer)
+    {
+        for(auto& clean : cleanLayers) {
+            clean = std::min(clean, firstChangedLayer);
+        }
+    }
+};
+
+// Network whose topology evolves along with its values. Copies share nothing but
+// keep the parent's compiled plan, so only structural mutations recompile.
+class GraphIndividual final : public Individual
+{
+public:
+    explicit GraphIndividual(const MiniBatch& samples_) : genome(1, 1, true), stddev{ 0.25 }, samples{ &samples_ }
+    {
+        for(auto& w : genome.getWeights()) {
+            w = getGaussianRand(0, 1.0);
+        }
+    }
+
+    void evaluate() override
+    {
+        thread_local std::vector<double> scratch;
+        const auto& dataset = samples->getDataset();
+        for(const auto idx : samples->getIndices()) {
+            double actual;
+            genome.run(dataset.getInputs(idx), &actual, scratch);
+            const auto diff = actual - *dataset.getTargets(idx);
+            fitness += diff * diff;
+        }
+        fitness /= static_cast<double>(samples->size());
+    }
+
+    void mutate() override
+    {
+        std::uniform_real_distribution<> chance(0, 1);
+        if(chance(generator) < addNodeRate) {
+            const auto& connections = genome.getConnections();
+            std::uniform_int_distribution<size_t> pick(0, connections.size() - 1);
+            const auto c = pick(generator);
+            if(connections[c].enabled) {
+                genome.addNode(c);
+            }
+        }
+        if(chance(generator) < addConnectionRate) {
+            std::uniform_int_distribution<size_t> pick(0, genome.getNumNodes() - 1);
+            for(int attempt = 0; attempt < 10; ++attempt) {
+                const auto from = pick(generator);
+                const auto to = pick(generator);
+                if(genome.canConnect(from, to)) {
+                    genome.addConnection(from, to, getGaussianRand(0, stddev));
+                    break;
+                }
+            }
+        }
+        for(auto& w : genome.getWeights()) {
+            w += getGaussianRand(0, stddev);
+        }
+        std::uniform_real_distribution<> dis(0.8, 1.2);
+        stddev *= dis(generator);
+        stddev = std::max(0.001, stddev);
+    }
+
+    void mutateFrom(const Individual* other) override
+    {
+        const auto& parent = *dynamic_cast<const GraphIndividual*>(other);
+        genome = parent.genome;
+        stddev = parent.stddev;
+        mutate();
+    }
+
+    std::unique_ptr<Individual> clone() const override
+    {
+        return std::make_unique<GraphIndividual>(*this);
+    }
+
+    void dump(std::ostream& os) const override
+    {
+        os << genome.getNumNodes() << " nodes / " << genome.getConnections().size() << " connections";
+    }
+
+    GraphGenome genome;
+    double stddev{0};
+
+private:
+    const MiniBatch* samples;
 };
 
 void converging1()
@@ -203,25 +741,82 @@ void evolution1()
     }
     anim.add_layer();
 
+    const auto dataset = makeTargetDataset();
+    const size_t miniBatchSize = 50; // 0: always evaluate on all samples
+    MiniBatch samples(dataset, miniBatchSize, generator());
+
+    // The distribution-based strategies need far fewer candidates per generation
+    enum class Optimizer { Truncation, CmaEs, OpenAiEs };
+    const auto optimizer = Optimizer::Truncation;
+
+    // Elites fine-tuned by gradient descent each generation, 0 for pure evolution.
+    // Only truncation selection keeps refined genomes; the strategies sample anew.
+    const size_t numRefined = optimizer == Optimizer::Truncation ? 1 : 0;
+
+    // Truncation selection runs on NnIndividual values without virtual calls,
+    // the strategies need the polymorphic population
+    const bool devirtualized = optimizer == Optimizer::Truncation && !numaEvaluation && !noveltySearch
+                               && !multiObjective && !useSurrogate;
     Population pop;
-    const size_t popSize = 1000;
+    StaticPopulation<NnIndividual> staticPop;
+    const size_t popSize = optimizer == Optimizer::Truncation ? 1000 : 50;
     for(size_t i = 0; i < popSize; ++i) {
-        pop.addIndividual(std::make_unique<NnIndividual>());
+        if(devirtualized) {
+            staticPop.addIndividual(NnIndividual(samples));
+        }
+        else {
+            pop.addIndividual(std::make_unique<NnIndividual>(samples));
+        }
+    }
+    pop.setNumRefined(numRefined);
+    staticPop.setNumRefined(numRefined);
+    pop.setCrossoverRate(crossoverRate, generator());
+    staticPop.setCrossoverRate(crossoverRate, generator());
+    if(numaEvaluation) {
+        pop.setNumaNodes(getNumaNodes());
+    }
+    if(noveltySearch) {
+        pop.setRanking(std::make_unique<NoveltySearch>(15, 2, noveltyWeight));
+    }
+    else if(multiObjective) {
+        pop.setRanking(std::make_unique<Nsga2>());
     }
+    if(useSurrogate) {
+        pop.setSurrogate(std::make_unique<Surrogate>(surrogateFraction));
+    }
+    if(optimizer == Optimizer::CmaEs) {
+        const auto& initialWeights = *pop.getIndividual(0)->getGenome();
+        pop.setStrategy(std::make_unique<CmaEs>(initialWeights, 0.25,
+            CmaEs::Covariance::Full, generator()));
+    }
+    else if(optimizer == Optimizer::OpenAiEs) {
+        const auto& initialWeights = *pop.getIndividual(0)->getGenome();
+        pop.setStrategy(std::make_unique<OpenAiEs>(initialWeights, 0.02, 0.01,
+            std::make_shared<NoiseTable>(), generator()));
+    }
+    const auto selectSamples = [&samples](bool fullSet) {
+        if(fullSet) {
+            samples.selectAll();
+        }
+        else {
+            samples.resample();
+        }
+    };
+    pop.setSampleSelector(selectSamples);
+    staticPop.setSampleSelector(selectSamples);
 
     const auto start = std::chrono::high_resolution_clock::now();
 
     size_t generation = 1;
-    NnIndividual best;
-    std::vector<double> outputs;
-
-    const auto drawBest = [&anim, &best, &outputs, &getMapX, &getMapY](size_t generation, int waits) {
+    NnIndividual best(samples);
+    const auto drawBest = [&anim, &best, &getMapX, &getMapY](size_t generation, int waits) {
+        TRACE_SCOPE("drawFrame");
+        auto& ws = NeuralNet::Workspace::local(best.nn);
         HtmlAnim::Vec2Vector points;
         for(int i = 0; i < sections + 1; ++i) {
             const double x = -M_PI + 2 * M_PI / sections * i;
             double inputs = x / M_PI;
-            const auto resultIdx = best.nn.run(&inputs, outputs);
-            const auto y = outputs[resultIdx];
+            const auto y = *best.nn.run(&inputs, ws);
             points.emplace_back(HtmlAnim::Vec2(getMapX(x), getMapY(y)));
         }
         anim.frame().save()
@@ -232,15 +827,66 @@ void evolution1()
         anim.next_frame();
     };
 
+    // The run ends at whichever criterion comes first; a deadline also cuts the
+    // generation under way short
     const size_t numGens = 2000;
+    StopCriteria criteria;
+    criteria.maxGenerations = numGens;
+    criteria.maxSeconds = 300;
+    criteria.stagnationGenerations = 500;
+    criteria.minImprovement = 0.01;
+    RunControl control(criteria);
+    pop.setRunControl(&control);
+    staticPop.setRunControl(&control);
+
+    // Every generation goes to the metrics log; metrics_csv turns it into CSV
+    MetricsLog metricsLog("metrics.bin", false);
+    GenerationMetrics metrics;
+    std::vector<double> fitnesses, stddevs;
+
     int numBests = 0;
     do {
-        pop.evolve();
-        const auto& curBest = *(dynamic_cast<NnIndividual*>(pop.getIndividual(0)));
+        const auto genStart = std::chrono::steady_clock::now();
+        if(devirtualized) {
+            staticPop.evolve();
+        }
+        else {
+            pop.evolve();
+        }
+        metrics.generationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - genStart).count();
+        // Other rankings than by fitness can put the fittest anywhere
+        size_t bestIdx = 0;
+        for(size_t i = 1; (noveltySearch || multiObjective) && i < pop.size(); ++i) {
+            if(pop.getIndividual(i)->getFitness() < pop.getIndividual(bestIdx)->getFitness()) {
+                bestIdx = i;
+            }
+        }
+        const auto& curBest = devirtualized ? staticPop.getIndividual(0)
+                                            : *(dynamic_cast<NnIndividual*>(pop.getIndividual(bestIdx)));
         if(generation == 1 || curBest.getFitness() < best.getFitness()) {
             best = curBest;
+            best.materialize();
             ++numBests;
+            ++metrics.improvements;
+        }
+
+        fitnesses.clear();
+        stddevs.clear();
+        for(size_t i = 0; i < (devirtualized ? staticPop.size() : pop.size()); ++i) {
+            const auto& idv = devirtualized ? staticPop.getIndividual(i)
+                                            : *dynamic_cast<const NnIndividual*>(pop.getIndividual(i));
+            // Screened-out and abandoned individuals have an infinite fitness
+            if(std::isfinite(idv.getFitness())) {
+                fitnesses.push_back(idv.getFitness());
+            }
+            stddevs.push_back(idv.stddev);
         }
+        metrics.generation = generation;
+        metrics.evaluations = devirtualized ? staticPop.getEvaluations() : pop.getEvaluations();
+        metrics.elapsedSeconds = control.getElapsedSeconds();
+        metrics.fitness = summarize(fitnesses);
+        metrics.stddev = summarize(stddevs);
+        metricsLog.log(metrics);
 
         if(generation == 1 || generation % 100 == 0) {
             const auto stop = std::chrono::high_resolution_clock::now();
@@ -254,19 +900,139 @@ void evolution1()
         }
 
         ++generation;
-    } while(generation < numGens);
+    } while(!control.update(best.getFitness(), devirtualized ? staticPop.getEvaluations() : pop.getEvaluations()));
+    std::cout << "stopped by " << toString(control.getStopReason()) << " after " << generation - 1
+              << " generations\n";
+    metricsLog.close();
 
     drawBest(generation, 180);
 
-    anim.write_file("progress.html");
+    {
+        TRACE_SCOPE("writeProgress");
+        anim.write_file("progress.html");
+    }
+
+    {
+        TRACE_SCOPE("writeHeader");
+        std::ofstream exported("best_net.h");
+        writeInferenceHeader(exported, best.nn, "best_net");
+    }
+
+    // Int8 copy of the best net, calibrated on the target samples
+    const auto allSamples = dataset.getBatch(0, dataset.size());
+    const QuantizedNet quantized(best.nn, allSamples.inputs, allSamples.size);
+    const auto report = compareQuantized(best.nn, quantized, allSamples.inputs, allSamples.size);
+    std::cout << "int8: max error " << report.maxAbsError
+              << " // rms error " << report.rmsError
+              << " // " << quantized.getMemoryBytes() << " bytes\n";
+
+    if(const auto surrogate = pop.getSurrogate()) {
+        const auto& screening = surrogate->getReport();
+        std::cout << "surrogate: " << screening.evaluated << " of " << screening.candidates
+                  << " candidates evaluated // savings " << screening.getSavings() * 100 << "%"
+                  << " // rank correlation " << screening.rankCorrelation << "\n";
+    }
+}
+
+void topologyEvolution()
+{
+    const auto dataset = makeTargetDataset();
+    MiniBatch samples(dataset, 50, generator());
+
+    Population pop;
+    for(size_t i = 0; i < 1000; ++i) {
+        pop.addIndividual(std::make_unique<GraphIndividual>(samples));
+    }
+    pop.setSampleSelector([&samples](bool fullSet) {
+        if(fullSet) {
+            samples.selectAll();
+        }
+        else {
+            samples.resample();
+        }
+    });
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    const size_t numGens = 2000;
+    for(size_t generation = 1; generation < numGens; ++generation) {
+        pop.evolve();
+        if(generation == 1 || generation % 100 == 0) {
+            const auto stop = std::chrono::high_resolution_clock::now();
+            const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            const auto best = pop.getIndividual(0);
+            std::cout << "gen " << generation << ": best " << best->getFitness() << " // ";
+            best->dump(std::cout);
+            std::cout << " // time " << duration.count() << " ms\n";
+        }
+    }
+}
+
+// Sweeps population size, initial mutation step size and hidden layer width over
+// all CPUs and writes a row per run to sweep.csv. Runs evaluate concurrently, which
+// every genome representation and the JIT support.
+void sweep1()
+{
+    const auto dataset = makeTargetDataset();
+    SweepSpec spec;
+    spec.addValues("population", { 100, 400 })
+        .addRange("stddev", 0.05, 0.5, true)
+        .addValues("hidden", { 4, 8 });
+    const auto points = spec.getGrid(2, 2, generator());
+
+    SweepRunner runner;
+    runner.setGenerations(300);
+    runner.setTargetFitness(0.005);
+    const auto results = runner.run(points, [&dataset](const SweepPoint& point) {
+        generator.seed(point.seed);
+        // Held by the sample selector, so the samples live as long as the population
+        const auto samples = std::make_shared<MiniBatch>(dataset, 50, generator());
+        const auto hidden = static_cast<size_t>(point.get("hidden"));
+        auto pop = std::make_unique<Population>();
+        for(size_t i = 0; i < point.get("population"); ++i) {
+            pop->addIndividual(std::make_unique<NnIndividual>(*samples, std::vector<size_t>{ hidden, hidden, 1 },
+                                                              point.get("stddev")));
+        }
+        pop->setNumRefined(1);
+        pop->setSampleSelector([samples](bool fullSet) {
+            if(fullSet) {
+                samples->selectAll();
+            }
+            else {
+                samples->resample();
+            }
+        });
+        return pop;
+    });
+
+    std::ofstream csv("sweep.csv");
+    writeSweepCsv(csv, results);
+
+    const auto best = std::min_element(results.cbegin(), results.cend(), [](const SweepResult& a, const SweepResult& b) {
+        return a.finalFitness < b.finalFitness;
+    });
+    std::cout << results.size() << " runs, best " << best->finalFitness << " with";
+    for(size_t i = 0; i < best->point.names.size(); ++i) {
+        std::cout << " " << best->point.names[i] << " " << best->point.values[i];
+    }
+    std::cout << "\n";
 }
 
 int main(int argc, char **argv)
 {
+    TRACE_THREAD_NAME("main");
     generator.seed(time(nullptr));
 
     // converging1();
-    evolution1();
+    if(runSweep) {
+        sweep1();
+    }
+    else if(evolveTopology) {
+        topologyEvolution();
+    }
+    else {
+        evolution1();
+    }
 
+    TRACE_WRITE("trace.json");
     return 0;
 }
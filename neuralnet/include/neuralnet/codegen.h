@@ -0,0 +1,26 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include "neuralnet/neuralnet.h"
+
+#include <ostream>
+#include <string>
+
+// Writes the C++ definition of
+//     extern "C" void functionName(const double* weights, const double* inputs, double* outputs)
+// computing NeuralNet::run for the topology of nn, with weights in the same flat
+// layout. Small nets are fully unrolled; larger ones get loops with constant
+// bounds. Operations are done in the same order as NeuralNet::run, so the
+// results are bit-identical when compiled without floating point contraction.
+void writeForwardFunction(std::ostream& os, const NeuralNet& nn, const std::string& functionName);
+
+// Writes a self-contained header declaring, in namespace name, the constexpr
+// weights of nn and an allocation-free
+//     inline void infer(const double* inputs, double* outputs)
+// equivalent to NeuralNet::run, for deploying an evolved net without this library.
+void writeInferenceHeader(std::ostream& os, const NeuralNet& nn, const std::string& name);
+
+// Key identifying everything writeForwardFunction depends on except the weights
+std::string getTopologyKey(const NeuralNet& nn);
+
+#endif // CODEGEN_H
@@ -0,0 +1,114 @@
+#ifndef GRAPHGENOME_H
+#define GRAPHGENOME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Network of arbitrary feed-forward topology grown by structural mutations, as in
+// NEAT. The first getInputs() nodes are the inputs, the next getOutputs() the outputs,
+// and hidden nodes follow in the order they were added. Hidden nodes use ReLU like
+// NeuralNet, outputs too unless they are linear.
+//
+// Every bias and connection weight is a value in getWeights(), appended when its
+// node or connection is added. Changing values keeps the structure, so the compiled
+// plan is only rebuilt after addConnection, addNode or setEnabled.
+class GraphGenome
+{
+public:
+    struct Connection
+    {
+        size_t from;
+        size_t to;
+        size_t weight; // index into getWeights()
+        bool enabled;
+    };
+
+    // Flat evaluation order of the nodes that reach an output, each with its
+    // incoming connections laid out contiguously
+    class Plan
+    {
+    public:
+        size_t getNumSteps() const { return steps.size(); }
+        size_t getNumOps() const { return ops.size(); }
+
+    private:
+        friend class GraphGenome;
+
+        struct Step
+        {
+            uint32_t node;
+            uint32_t bias;
+            uint32_t opsEnd;
+            bool linear;
+        };
+        struct Op
+        {
+            uint32_t source;
+            uint32_t weight;
+        };
+
+        std::vector<Step> steps;
+        std::vector<Op> ops;
+    };
+
+    GraphGenome() : nInputs{0}, nOutputs{0}, outputLinear{false}, planStale{true}, compilations{0} {}
+
+    // Starts with every input connected to every output, all values zero
+    GraphGenome(size_t nInputs, size_t nOutputs, bool outputIsLinear = false);
+
+    size_t getInputs() const { return nInputs; }
+    size_t getOutputs() const { return nOutputs; }
+    size_t getNumNodes() const { return nInputs + biases.size(); }
+    bool isOutputLinear() const { return outputLinear; }
+
+    std::vector<double>& getWeights() { return weights; }
+    const std::vector<double>& getWeights() const { return weights; }
+
+    const std::vector<Connection>& getConnections() const { return connections; }
+
+    // Index of node's bias in getWeights(); inputs have none
+    size_t getBiasIndex(size_t node) const { return biases[node - nInputs]; }
+
+    // True if from -> to can be added: to is no input, there is no such connection
+    // yet, and it closes no cycle
+    bool canConnect(size_t from, size_t to) const;
+
+    // Returns the index of the new connection; canConnect(from, to) must hold
+    size_t addConnection(size_t from, size_t to, double weight);
+
+    // Splits an enabled connection: it is disabled and a new node, which is returned,
+    // takes its place with an input weight of 1 and the old weight on its output.
+    // The outputs stay the same unless the source is an input with a negative value.
+    size_t addNode(size_t connection);
+
+    // Disabled connections stay in the genome, so enabling one never closes a cycle
+    void setEnabled(size_t connection, bool enabled);
+
+    // Writes the outputs to outputs[0..]. scratch holds a value per node.
+    // Compiles the plan first if the structure changed since the last run, which
+    // makes concurrent runs of one genome safe only after compile().
+    void run(const double* inputs, double* outputs, std::vector<double>& scratch) const;
+
+    const Plan& compile() const;
+
+    // Number of times a plan was built, to check it is being reused
+    size_t getCompilations() const { return compilations; }
+
+private:
+    bool reaches(size_t from, size_t to) const;
+
+    size_t nInputs;
+    size_t nOutputs;
+    bool outputLinear;
+
+    std::vector<double> weights;
+    std::vector<size_t> biases; // per non-input node
+    std::vector<Connection> connections;
+
+    mutable Plan plan;
+    mutable bool planStale;
+    mutable size_t compilations;
+};
+
+#endif // GRAPHGENOME_H
@@ -0,0 +1,38 @@
+#ifndef INTERLEAVED_H
+#define INTERLEAVED_H
+
+#include "neuralnet/neuralnet.h"
+
+#include <cstddef>
+#include <vector>
+
+// Up to maxLanes nets of one topology with their weights stored lane by lane, so
+// one pass over the weights runs all of them on the same inputs. The loops over
+// the lanes have a fixed length and vectorize. Each lane does the operations of
+// NeuralNet::run for its net in the same order, so the results are identical
+// when neither is contracted into FMA, which the neuralnet target turns off.
+class InterleavedNets
+{
+public:
+    static constexpr size_t maxLanes = 8;
+
+    InterleavedNets() : nInputs{0}, nNets{0}, outputLinear{false} {}
+
+    // All nets must share the topology of nets[0]; n <= maxLanes. Unused lanes are zero.
+    void load(const NeuralNet* const* nets, size_t n);
+
+    size_t size() const { return nNets; }
+
+    // Output k of net i is returned at [k * maxLanes + i]. It stays valid until the next run.
+    const double* run(const double* inputs);
+
+private:
+    size_t nInputs;
+    std::vector<size_t> layerSizes;
+    size_t nNets;
+    bool outputLinear;
+    std::vector<double> weights;
+    std::vector<double> activations;
+};
+
+#endif // INTERLEAVED_H
@@ -0,0 +1,50 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "neuralnet/neuralnet.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Compiles forward passes specialized for a topology at runtime: the generated
+// source is built into a shared library by a local compiler and loaded with
+// dlopen. Libraries are kept in cacheDir, named by a hash of the topology, the
+// compiler and its flags, and reused by later runs. cacheDir is created with mode
+// 0700. Nothing is loaded unless the directory and the library belong to the
+// current user and nobody else can write to them.
+class JitCompiler
+{
+public:
+    using ForwardFunction = void (*)(const double* weights, const double* inputs, double* outputs);
+
+    explicit JitCompiler(std::string cacheDir = getDefaultCacheDir(), std::string compiler = "");
+    ~JitCompiler();
+
+    JitCompiler(JitCompiler const&) = delete;
+    JitCompiler& operator=(JitCompiler const&) = delete;
+
+    // Forward pass for the topology of nn, or nullptr if it could not be built,
+    // in which case callers fall back to NeuralNet::run. Failures are remembered.
+    ForwardFunction get(const NeuralNet& nn);
+
+    // Runs nn through its compiled forward pass if available, else through
+    // NeuralNet::run. Returns the index of the first output like NeuralNet::run.
+    // Looks the function up on every call; hot loops should call get() once.
+    size_t run(const NeuralNet& nn, const double* inputs, std::vector<double>& outputs);
+
+    // $XDG_CACHE_HOME/evolvenn_jit, else ~/.cache/evolvenn_jit
+    static std::string getDefaultCacheDir();
+
+private:
+    ForwardFunction build(const NeuralNet& nn, const std::string& key);
+
+    std::string cacheDir;
+    std::string compiler;
+    std::mutex mutex;
+    std::unordered_map<std::string, ForwardFunction> functions;
+    std::vector<void*> libraries;
+};
+
+#endif // JIT_H
@@ -1,6 +1,7 @@
 #ifndef NEURALNET_H
 #define NEURALNET_H
 
+#include <cstddef>
 #include <vector>
 
 class NeuralNet
@@ -9,8 +10,59 @@ public:
     NeuralNet() : nInputs{0}, outputLinear{false} {}
     explicit NeuralNet(size_t nInputs, const std::vector<size_t>& layerSizes, bool outputIsLinear=false);
 
+    // Activation buffers for run, 64-byte aligned and sized once. A workspace
+    // fits every net whose widest layer is no wider than the one it was sized for.
+    class Workspace
+    {
+    public:
+        static constexpr size_t alignment = 64;
+
+        Workspace() : stride{0}, data{nullptr} {}
+        explicit Workspace(const NeuralNet& nn) : Workspace() { reserve(nn); }
+
+        // Moving keeps the vector's buffer, so data stays valid
+        Workspace(const Workspace&) = delete;
+        Workspace& operator=(const Workspace&) = delete;
+        Workspace(Workspace&&) = default;
+        Workspace& operator=(Workspace&&) = default;
+
+        void reserve(const NeuralNet& nn);
+        bool fits(const NeuralNet& nn) const;
+
+        // Buffer of at least the output layer's size for writing outputs elsewhere
+        double* getOutputs() { return data; }
+
+        // Workspace of the calling thread, grown to fit nn. It is shared by all
+        // callers on that thread, so results must be used before the next run.
+        static Workspace& local(const NeuralNet& nn);
+
+    private:
+        friend class NeuralNet;
+
+        size_t stride;
+        std::vector<double> storage;
+        double* data;
+    };
+
     size_t run(const double* inputs, std::vector<double>& outputs) const;
 
+    // Same as above without any checks or allocation; ws must fit this net.
+    // Returns the outputs, which live in ws until its next use.
+    const double* run(const double* inputs, Workspace& ws) const;
+
+    // Like run, but the activations of all hidden layers are kept in trace
+    // (getTraceSize() values, layer after layer). Starting at firstLayer > 0 reads
+    // that layer's inputs from the trace instead of inputs, which is then unused,
+    // and only recomputes layers from firstLayer on. The outputs start at outputs[0].
+    void run(const double* inputs, std::vector<double>& outputs, double* trace, size_t firstLayer = 0) const;
+    void run(const double* inputs, double* outputs, double* trace, size_t firstLayer = 0) const;
+
+    // Adds the gradient of 0.5 * |outputs - targets|^2 with respect to the weights
+    // onto gradients, which has the layout of the weights, and returns that loss.
+    // scratch holds the activations and deltas of all neurons.
+    double backprop(const double* inputs, const double* targets,
+                    std::vector<double>& gradients, std::vector<double>& scratch) const;
+
     std::vector<double>& getWeights() { return weights; }
     const std::vector<double>& getWeights() const { return weights; }
     void setWeights(std::vector<double>&& w) { weights = w; }
@@ -18,6 +70,10 @@ public:
 
     size_t getInputs() const { return nInputs; }
     const std::vector<size_t>& getLayerSizes() const { return layerSizes; }
+    bool isOutputLinear() const { return outputLinear; }
+
+    size_t getTraceSize() const;
+    size_t getLayerWeightsBegin(size_t layer) const;
 
 private:
     size_t nInputs;
@@ -0,0 +1,67 @@
+#ifndef QUANTIZED_H
+#define QUANTIZED_H
+
+#include "neuralnet/neuralnet.h"
+
+#include <cstdint>
+#include <vector>
+
+// Int8 copy of a NeuralNet for fast, compact inference. Weights are quantized
+// symmetrically per layer; layer inputs are unsigned 8-bit with a per-layer
+// scale found by calibration (hidden ReLU outputs use 0..255, net inputs are
+// offset by 128 to fit). Dot products accumulate exactly in int32, with
+// AVX-VNNI / AVX512-VNNI dpbusd or AVX2 madd kernels when the CPU has them.
+class QuantizedNet
+{
+public:
+    QuantizedNet() : outputLinear{false} {}
+
+    // calibrationInputs holds nSamples rows of nn.getInputs() values, e.g. a DatasetBatch
+    QuantizedNet(const NeuralNet& nn, const double* calibrationInputs, size_t nSamples);
+
+    // Writes the outputs to outputs[0..]. scratch holds the quantized activations.
+    void run(const double* inputs, double* outputs, std::vector<uint8_t>& scratch) const;
+
+    size_t getInputs() const { return layers.empty() ? 0 : layers.front().nInputs; }
+    size_t getOutputs() const { return layers.empty() ? 0 : layers.back().nOutputs; }
+    size_t getMemoryBytes() const;
+
+private:
+    struct Layer
+    {
+        size_t nInputs;
+        size_t nOutputs;
+        size_t stride;              // nInputs rounded up to a SIMD block
+        std::vector<int8_t> weights; // nOutputs rows of stride
+        std::vector<double> offsets; // bias minus the input zero point correction
+        double scale;               // weight scale times input scale
+        double inputScale;
+        uint8_t inputZeroPoint;
+    };
+
+    std::vector<Layer> layers;
+    bool outputLinear;
+};
+
+// Int8 dot product kernels, all giving the same exact result
+enum class DotKernel { Scalar, Avx2, AvxVnni, Avx512Vnni };
+
+// Kernels this CPU can run, Scalar first and the one QuantizedNet uses last
+std::vector<DotKernel> getSupportedDotKernels();
+
+// Sum of x[i] * w[i] by the given kernel; n must be a multiple of 32
+int32_t quantizedDot(const uint8_t* x, const int8_t* w, size_t n, DotKernel kernel);
+
+// Accuracy of the quantized path against NeuralNet::run over the given inputs
+struct QuantizationReport
+{
+    size_t samples;
+    double maxAbsError;
+    double rmsError;
+    double maxAbsOutput;
+};
+
+QuantizationReport compareQuantized(const NeuralNet& nn, const QuantizedNet& quantized,
+                                    const double* inputs, size_t nSamples);
+
+#endif // QUANTIZED_H
@@ -0,0 +1,56 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "neuralnet/neuralnet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fraction of the connection weights (biases excluded) that are nonzero
+double getDensity(const NeuralNet& nn);
+
+// Zeroes the connection weights with magnitude below threshold and returns how many
+size_t pruneWeights(NeuralNet& nn, double threshold);
+
+// Zeroes the smallest connection weights so that at most density of them stay
+size_t pruneToDensity(NeuralNet& nn, double density);
+
+// Below this density the sparse path beats the dense one with some margin; on a
+// 64-512-512-10 net they break even at about 0.6 (see sparse_bench)
+constexpr double defaultSparseDensity = 0.4;
+
+inline bool preferSparse(const NeuralNet& nn, double maxDensity = defaultSparseDensity)
+{
+    return getDensity(nn) < maxDensity;
+}
+
+// Compressed sparse row copy of a NeuralNet: per neuron, its bias and only the
+// nonzero connections, so a forward pass costs time in the number of nonzeros.
+// Gives the same outputs as NeuralNet::run.
+class SparseNet
+{
+public:
+    SparseNet() : nInputs{0}, outputLinear{false} {}
+    explicit SparseNet(const NeuralNet& nn) : SparseNet() { assign(nn); }
+
+    // Rebuilds from nn, reusing the buffers
+    void assign(const NeuralNet& nn);
+
+    // Writes the outputs to outputs[0..]. scratch holds the activations.
+    void run(const double* inputs, double* outputs, std::vector<double>& scratch) const;
+
+    size_t getNonZeros() const { return values.size(); }
+
+private:
+    size_t nInputs;
+    std::vector<size_t> layerSizes;
+    bool outputLinear;
+
+    std::vector<double> biases;
+    std::vector<size_t> rowStarts; // per neuron of all layers, plus one past the end
+    std::vector<uint32_t> columns;
+    std::vector<double> values;
+};
+
+#endif // SPARSE_H
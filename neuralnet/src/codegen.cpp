@@ -0,0 +1,133 @@
+#include "neuralnet/codegen.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+// Beyond this many weights straight-line code gets too large to compile quickly
+const size_t unrollLimit = 4096;
+
+void writeForwardBody(std::ostream& os, const NeuralNet& nn);
+
+}
+
+std::string getTopologyKey(const NeuralNet& nn)
+{
+    std::ostringstream key;
+    key << "v1:" << nn.getInputs() << ":";
+    for(const auto lrSz : nn.getLayerSizes()) {
+        key << lrSz << ",";
+    }
+    key << (nn.isOutputLinear() ? "linear" : "relu");
+    return key.str();
+}
+
+void writeForwardFunction(std::ostream& os, const NeuralNet& nn, const std::string& functionName)
+{
+    os << "// Generated forward pass for topology " << getTopologyKey(nn) << "\n"
+       << "extern \"C\" void " << functionName
+       << "(const double* weights, const double* inputs, double* outputs)\n{\n";
+    writeForwardBody(os, nn);
+    os << "}\n";
+}
+
+void writeInferenceHeader(std::ostream& os, const NeuralNet& nn, const std::string& name)
+{
+    const auto& weights = nn.getWeights();
+
+    os << "// Generated by evolvenn: standalone inference for topology " << getTopologyKey(nn) << "\n"
+       << "// Compile without floating point contraction (e.g. -ffp-contract=off) for\n"
+       << "// results bit-identical to NeuralNet::run.\n"
+       << "#pragma once\n\n"
+       << "#include <cstddef>\n\n"
+       << "namespace " << name << " {\n\n"
+       << "constexpr std::size_t numInputs = " << nn.getInputs() << ";\n"
+       << "constexpr std::size_t numOutputs = " << nn.getLayerSizes().back() << ";\n\n"
+       << "constexpr double weights[" << weights.size() << "] = {\n";
+
+    // Hexadecimal literals round-trip every bit of the weights
+    std::ostringstream literals;
+    literals << std::hexfloat;
+    for(size_t i = 0; i < weights.size(); ++i) {
+        literals.str("");
+        literals << weights[i];
+        os << (i % 4 == 0 ? "    " : " ") << literals.str() << ",";
+        if(i % 4 == 3 || i + 1 == weights.size()) {
+            os << "\n";
+        }
+    }
+
+    os << "};\n\n"
+       << "inline void infer(const double* inputs, double* outputs)\n{\n";
+    writeForwardBody(os, nn);
+    os << "}\n\n"
+       << "} // namespace " << name << "\n";
+}
+
+namespace {
+
+void writeForwardBody(std::ostream& os, const NeuralNet& nn)
+{
+    const auto& layerSizes = nn.getLayerSizes();
+
+    if(nn.getWeights().size() <= unrollLimit) {
+        // Each neuron becomes one local: bias, then inputs added in order
+        size_t w = 0;
+        std::string lastPrefix = "inputs[";
+        std::string lastSuffix = "]";
+        auto lastInputs = nn.getInputs();
+        for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+            const bool isOutputLayer = (lrIdx == layerSizes.size() - 1);
+            const bool linear = isOutputLayer && nn.isOutputLinear();
+            const std::string prefix = isOutputLayer ? "outputs[" : "a" + std::to_string(lrIdx) + "_";
+            const std::string suffix = isOutputLayer ? "]" : "";
+            for(size_t neuIdx = 0; neuIdx < layerSizes[lrIdx]; ++neuIdx) {
+                const auto name = "s" + std::to_string(lrIdx) + "_" + std::to_string(neuIdx);
+                os << "    double " << name << " = weights[" << w++ << "];\n";
+                for(size_t k = 0; k < lastInputs; ++k) {
+                    os << "    " << name << " += weights[" << w++ << "] * "
+                       << lastPrefix << k << lastSuffix << ";\n";
+                }
+                os << "    " << (isOutputLayer ? "" : "const double ") << prefix << neuIdx << suffix << " = ";
+                if(linear) {
+                    os << name << ";\n";
+                }
+                else {
+                    os << "0.0 < " << name << " ? " << name << " : 0.0;\n";
+                }
+            }
+            lastPrefix = prefix;
+            lastSuffix = suffix;
+            lastInputs = layerSizes[lrIdx];
+        }
+    }
+    else {
+        size_t maxSize = 0;
+        for(const auto lrSz : layerSizes) {
+            maxSize = lrSz > maxSize ? lrSz : maxSize;
+        }
+        os << "    double buffers[2][" << maxSize << "];\n"
+           << "    const double* in = inputs;\n"
+           << "    const double* w = weights;\n";
+        auto lastInputs = nn.getInputs();
+        for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+            const bool isOutputLayer = (lrIdx == layerSizes.size() - 1);
+            const bool linear = isOutputLayer && nn.isOutputLinear();
+            const std::string out = isOutputLayer ? "outputs" : "buffers[" + std::to_string(lrIdx % 2) + "]";
+            os << "    for(int n = 0; n < " << layerSizes[lrIdx] << "; ++n) {\n"
+               << "        double s = *w++;\n"
+               << "        for(int k = 0; k < " << lastInputs << "; ++k) {\n"
+               << "            s += *w++ * in[k];\n"
+               << "        }\n"
+               << "        " << out << "[n] = " << (linear ? "s" : "0.0 < s ? s : 0.0") << ";\n"
+               << "    }\n";
+            if(!isOutputLayer) {
+                os << "    in = " << out << ";\n";
+            }
+            lastInputs = layerSizes[lrIdx];
+        }
+    }
+}
+
+}
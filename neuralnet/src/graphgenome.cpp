@@ -0,0 +1,190 @@
+#include "neuralnet/graphgenome.h"
+
+#include <algorithm>
+#include <cassert>
+
+GraphGenome::GraphGenome(size_t nInputs_, size_t nOutputs_, bool outputIsLinear)
+    : nInputs{nInputs_}, nOutputs{nOutputs_}, outputLinear{outputIsLinear}, planStale{true}, compilations{0}
+{
+    for(size_t out = 0; out < nOutputs; ++out) {
+        biases.push_back(weights.size());
+        weights.push_back(0);
+    }
+    for(size_t out = 0; out < nOutputs; ++out) {
+        for(size_t in = 0; in < nInputs; ++in) {
+            addConnection(in, nInputs + out, 0);
+        }
+    }
+}
+
+bool GraphGenome::reaches(size_t from, size_t to) const
+{
+    // Depth-first over all connections, disabled ones included, so that no later
+    // change can close a cycle either
+    std::vector<size_t> stack{ from };
+    std::vector<bool> visited(getNumNodes(), false);
+    visited[from] = true;
+    while(!stack.empty()) {
+        const auto node = stack.back();
+        stack.pop_back();
+        if(node == to) {
+            return true;
+        }
+        for(const auto& c : connections) {
+            if(c.from == node && !visited[c.to]) {
+                visited[c.to] = true;
+                stack.push_back(c.to);
+            }
+        }
+    }
+    return false;
+}
+
+bool GraphGenome::canConnect(size_t from, size_t to) const
+{
+    if(from >= getNumNodes() || to >= getNumNodes() || to < nInputs || from == to) {
+        return false;
+    }
+    for(const auto& c : connections) {
+        if(c.from == from && c.to == to) {
+            return false;
+        }
+    }
+    return !reaches(to, from);
+}
+
+size_t GraphGenome::addConnection(size_t from, size_t to, double weight)
+{
+    assert(canConnect(from, to));
+    connections.push_back(Connection{ from, to, weights.size(), true });
+    weights.push_back(weight);
+    planStale = true;
+    return connections.size() - 1;
+}
+
+size_t GraphGenome::addNode(size_t connection)
+{
+    assert(connection < connections.size() && connections[connection].enabled);
+    connections[connection].enabled = false;
+    const auto split = connections[connection];
+
+    const auto node = getNumNodes();
+    biases.push_back(weights.size());
+    weights.push_back(0);
+    connections.push_back(Connection{ split.from, node, weights.size(), true });
+    weights.push_back(1);
+    connections.push_back(Connection{ node, split.to, weights.size(), true });
+    weights.push_back(weights[split.weight]);
+    planStale = true;
+    return node;
+}
+
+void GraphGenome::setEnabled(size_t connection, bool enabled)
+{
+    assert(connection < connections.size());
+    if(connections[connection].enabled != enabled) {
+        connections[connection].enabled = enabled;
+        planStale = true;
+    }
+}
+
+const GraphGenome::Plan& GraphGenome::compile() const
+{
+    if(!planStale) {
+        return plan;
+    }
+    const auto nNodes = getNumNodes();
+
+    // Incoming enabled connections per node
+    std::vector<std::vector<size_t>> incoming(nNodes);
+    for(size_t i = 0; i < connections.size(); ++i) {
+        if(connections[i].enabled) {
+            incoming[connections[i].to].push_back(i);
+        }
+    }
+
+    // Only nodes some output depends on are computed
+    std::vector<bool> needed(nNodes, false);
+    std::vector<size_t> stack;
+    for(size_t node = nInputs; node < nInputs + nOutputs; ++node) {
+        needed[node] = true;
+        stack.push_back(node);
+    }
+    while(!stack.empty()) {
+        const auto node = stack.back();
+        stack.pop_back();
+        for(const auto i : incoming[node]) {
+            const auto from = connections[i].from;
+            if(!needed[from]) {
+                needed[from] = true;
+                stack.push_back(from);
+            }
+        }
+    }
+
+    // Kahn's algorithm over the needed non-input nodes
+    std::vector<size_t> pending(nNodes, 0);
+    std::vector<std::vector<size_t>> outgoing(nNodes);
+    for(size_t node = nInputs; node < nNodes; ++node) {
+        if(!needed[node]) {
+            continue;
+        }
+        for(const auto i : incoming[node]) {
+            const auto from = connections[i].from;
+            if(from >= nInputs) {
+                ++pending[node];
+                outgoing[from].push_back(node);
+            }
+        }
+    }
+    std::vector<size_t> ready;
+    for(size_t node = nInputs; node < nNodes; ++node) {
+        if(needed[node] && !pending[node]) {
+            ready.push_back(node);
+        }
+    }
+
+    plan.steps.clear();
+    plan.ops.clear();
+    for(size_t next = 0; next < ready.size(); ++next) {
+        const auto node = ready[next];
+        for(const auto i : incoming[node]) {
+            plan.ops.push_back(Plan::Op{ static_cast<uint32_t>(connections[i].from),
+                                         static_cast<uint32_t>(connections[i].weight) });
+        }
+        const bool isOutput = node < nInputs + nOutputs;
+        plan.steps.push_back(Plan::Step{ static_cast<uint32_t>(node), static_cast<uint32_t>(getBiasIndex(node)),
+                                         static_cast<uint32_t>(plan.ops.size()), isOutput && outputLinear });
+        for(const auto to : outgoing[node]) {
+            if(--pending[to] == 0) {
+                ready.push_back(to);
+            }
+        }
+    }
+    assert(std::count(needed.begin() + nInputs, needed.end(), true) == static_cast<long>(plan.steps.size()));
+
+    planStale = false;
+    ++compilations;
+    return plan;
+}
+
+void GraphGenome::run(const double* inputs, double* outputs, std::vector<double>& scratch) const
+{
+    const auto& p = compile();
+    if(scratch.size() < getNumNodes()) {
+        scratch.resize(getNumNodes());
+    }
+    double* values = scratch.data();
+    std::copy(inputs, inputs + nInputs, values);
+
+    const double* w = weights.data();
+    const auto* op = p.ops.data();
+    for(const auto& step : p.steps) {
+        auto weightedInputs = w[step.bias];
+        for(const auto* end = p.ops.data() + step.opsEnd; op != end; ++op) {
+            weightedInputs += w[op->weight] * values[op->source];
+        }
+        values[step.node] = step.linear ? weightedInputs : std::max(0.0, weightedInputs);
+    }
+    std::copy(values + nInputs, values + nInputs + nOutputs, outputs);
+}
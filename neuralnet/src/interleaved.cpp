@@ -0,0 +1,80 @@
+#include "neuralnet/interleaved.h"
+
+#include <algorithm>
+#include <cassert>
+
+void InterleavedNets::load(const NeuralNet* const* nets, size_t n)
+{
+    assert(n > 0 && n <= maxLanes);
+    const auto& first = *nets[0];
+    nInputs = first.getInputs();
+    layerSizes = first.getLayerSizes();
+    outputLinear = first.isOutputLinear();
+    nNets = n;
+
+    const auto nWeights = first.getWeights().size();
+    weights.resize(nWeights * maxLanes);
+    for(size_t lane = 0; lane < maxLanes; ++lane) {
+        if(lane < n) {
+            assert(nets[lane]->getLayerSizes() == layerSizes);
+            const auto& w = nets[lane]->getWeights();
+            for(size_t i = 0; i < nWeights; ++i) {
+                weights[i * maxLanes + lane] = w[i];
+            }
+        }
+        else {
+            for(size_t i = 0; i < nWeights; ++i) {
+                weights[i * maxLanes + lane] = 0;
+            }
+        }
+    }
+
+    const auto maxLayer = *std::max_element(layerSizes.cbegin(), layerSizes.cend());
+    activations.resize(2 * maxLayer * maxLanes);
+}
+
+const double* InterleavedNets::run(const double* inputs)
+{
+    const auto maxLayer = activations.size() / (2 * maxLanes);
+    const double* w = weights.data();
+    const double* layerInputs = nullptr;
+    auto lastInputs = nInputs;
+    for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+        const auto lrSz = layerSizes[lrIdx];
+        double* layerOutputs = activations.data() + (lrIdx % 2) * maxLayer * maxLanes;
+        const bool linearOutput = (lrIdx == layerSizes.size() - 1) && outputLinear;
+
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            double sums[maxLanes];
+            for(size_t lane = 0; lane < maxLanes; ++lane) {
+                sums[lane] = w[lane];
+            }
+            w += maxLanes;
+            // The net inputs are shared by all lanes, hidden activations are per lane
+            if(layerInputs) {
+                for(size_t k = 0; k < lastInputs; ++k) {
+                    for(size_t lane = 0; lane < maxLanes; ++lane) {
+                        sums[lane] += w[lane] * layerInputs[k * maxLanes + lane];
+                    }
+                    w += maxLanes;
+                }
+            }
+            else {
+                for(size_t k = 0; k < lastInputs; ++k) {
+                    const auto x = inputs[k];
+                    for(size_t lane = 0; lane < maxLanes; ++lane) {
+                        sums[lane] += w[lane] * x;
+                    }
+                    w += maxLanes;
+                }
+            }
+            for(size_t lane = 0; lane < maxLanes; ++lane) {
+                layerOutputs[neuIdx * maxLanes + lane] = linearOutput ? sums[lane] : std::max(0.0, sums[lane]);
+            }
+        }
+
+        layerInputs = layerOutputs;
+        lastInputs = lrSz;
+    }
+    return layerInputs;
+}
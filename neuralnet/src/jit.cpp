@@ -0,0 +1,189 @@
+#include "neuralnet/jit.h"
+#include "neuralnet/codegen.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JIT_HAS_DLOPEN 1
+#endif
+
+namespace {
+
+const char* const functionName = "nn_forward";
+
+// No contraction into FMA, to match NeuralNet::run bit for bit
+const char* const compilerFlags = "-O2 -fPIC -shared -ffp-contract=off";
+
+// FNV-1a, stable across runs and builds unlike std::hash
+uint64_t hashKey(const std::string& key)
+{
+    uint64_t h = 14695981039346656037ull;
+    for(const auto c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+#ifdef JIT_HAS_DLOPEN
+// Whether path is a directory or regular file, not a symlink, of the current
+// user that nobody else may write to. Anything loaded with dlopen runs in this
+// process, so only what this user put in its own cache qualifies.
+bool isPrivate(const std::filesystem::path& path, bool isDirectory)
+{
+    struct stat info;
+    if(lstat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    const mode_t type = isDirectory ? S_IFDIR : S_IFREG;
+    return (info.st_mode & S_IFMT) == type && info.st_uid == getuid() && (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+#endif
+
+}
+
+JitCompiler::JitCompiler(std::string cacheDir_, std::string compiler_)
+    : cacheDir{ std::move(cacheDir_) },
+      compiler{ std::move(compiler_) }
+{
+    if(compiler.empty()) {
+        const auto env = std::getenv("CXX");
+        compiler = env ? env : "c++";
+    }
+}
+
+JitCompiler::~JitCompiler()
+{
+#ifdef JIT_HAS_DLOPEN
+    for(const auto handle : libraries) {
+        dlclose(handle);
+    }
+#endif
+}
+
+std::string JitCompiler::getDefaultCacheDir()
+{
+    namespace fs = std::filesystem;
+
+    // The per-user cache of the XDG base directory spec
+    const auto xdg = std::getenv("XDG_CACHE_HOME");
+    if(xdg && fs::path(xdg).is_absolute()) {
+        return (fs::path(xdg) / "evolvenn_jit").string();
+    }
+    const auto home = std::getenv("HOME");
+    if(home && fs::path(home).is_absolute()) {
+        return (fs::path(home) / ".cache" / "evolvenn_jit").string();
+    }
+    std::error_code ec;
+    const auto tmp = fs::temp_directory_path(ec);
+#ifdef JIT_HAS_DLOPEN
+    const auto user = "evolvenn_jit_" + std::to_string(getuid());
+#else
+    const std::string user = "evolvenn_jit";
+#endif
+    return ((ec ? fs::path(".") : tmp) / user).string();
+}
+
+JitCompiler::ForwardFunction JitCompiler::get(const NeuralNet& nn)
+{
+    const auto key = getTopologyKey(nn);
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = functions.find(key);
+    if(it != functions.end()) {
+        return it->second;
+    }
+    const auto function = build(nn, key);
+    functions[key] = function;
+    return function;
+}
+
+size_t JitCompiler::run(const NeuralNet& nn, const double* inputs, std::vector<double>& outputs)
+{
+    const auto function = get(nn);
+    if(!function) {
+        return nn.run(inputs, outputs);
+    }
+    if(outputs.size() < nn.getLayerSizes().back()) {
+        outputs.resize(nn.getLayerSizes().back());
+    }
+    function(nn.getWeights().data(), inputs, outputs.data());
+    return 0;
+}
+
+JitCompiler::ForwardFunction JitCompiler::build(const NeuralNet& nn, const std::string& key)
+{
+#ifdef JIT_HAS_DLOPEN
+    namespace fs = std::filesystem;
+
+    // Libraries built by another compiler or with other flags get other names
+    std::ostringstream name;
+    name << "nn_" << std::hex << hashKey(key + "\n" + compiler + " " + compilerFlags);
+    const auto dir = fs::path(cacheDir);
+    const auto libPath = dir / (name.str() + ".so");
+
+    std::error_code ec;
+    if(dir.has_parent_path()) {
+        fs::create_directories(dir.parent_path(), ec);
+    }
+    mkdir(dir.c_str(), 0700);
+    if(!isPrivate(dir, true)) {
+        return nullptr;
+    }
+
+    if(!fs::exists(libPath, ec)) {
+
+        // Unique temporaries, renamed into place, so concurrent processes do not clash
+        const auto unique = name.str() + "_" + std::to_string(::getpid());
+        const auto srcPath = dir / (unique + ".cpp");
+        const auto tmpLibPath = dir / (unique + ".so");
+        {
+            std::ofstream src(srcPath);
+            if(!src) {
+                return nullptr;
+            }
+            writeForwardFunction(src, nn, functionName);
+        }
+
+        const auto command = compiler + " " + compilerFlags + " -o \""
+                             + tmpLibPath.string() + "\" \"" + srcPath.string() + "\" 2>/dev/null";
+        const auto status = std::system(command.c_str());
+        fs::remove(srcPath, ec);
+        if(status != 0) {
+            fs::remove(tmpLibPath, ec);
+            return nullptr;
+        }
+        fs::rename(tmpLibPath, libPath, ec);
+        if(ec) {
+            fs::remove(tmpLibPath, ec);
+            return nullptr;
+        }
+    }
+
+    if(!isPrivate(libPath, false)) {
+        return nullptr;
+    }
+    const auto handle = dlopen(libPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if(!handle) {
+        return nullptr;
+    }
+    const auto symbol = dlsym(handle, functionName);
+    if(!symbol) {
+        dlclose(handle);
+        return nullptr;
+    }
+    libraries.push_back(handle);
+    return reinterpret_cast<ForwardFunction>(symbol);
+#else
+    (void)nn;
+    (void)key;
+    return nullptr;
+#endif
+}
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cstdint>
 
 NeuralNet::NeuralNet(size_t nInputs_, const std::vector<size_t>& layerSizes_, bool outputIsLinear)
     : nInputs{ nInputs_ },
@@ -12,7 +13,7 @@ NeuralNet::NeuralNet(size_t nInputs_, const std::vector<size_t>& layerSizes_, bo
     auto lastInputs = nInputs;
     for(size_t i = 0; i < layerSizes.size(); ++i) {
         const auto lrSz = layerSizes[i];
-        nWeights += (1 + lrSz) * lastInputs;
+        nWeights += lrSz * (1 + lastInputs);
         lastInputs = lrSz;
     }
     weights.resize(nWeights);
@@ -51,3 +52,218 @@ size_t NeuralNet::run(const double* inputs, std::vector<double>& outputs) const
 
     return outputBegin;
 }
+
+const double* NeuralNet::run(const double* inputs, Workspace& ws) const
+{
+    assert(ws.fits(*this));
+
+    auto inputPtr = inputs;
+    auto lastInputs = nInputs;
+    size_t weightsBegin = 0;
+    for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+        const auto lrSz = layerSizes[lrIdx];
+        double* layerOutputs = ws.data + (lrIdx % 2) * ws.stride;
+
+        const bool isOutputLayer = (lrIdx == layerSizes.size() - 1);
+        const bool linearOutput = isOutputLayer && outputLinear;
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            auto weightedInputs = weights[weightsBegin++];
+            for(size_t w = 0; w < lastInputs; ++w) {
+                weightedInputs += weights[weightsBegin++] * inputPtr[w];
+            }
+            layerOutputs[neuIdx] = linearOutput ? weightedInputs : std::max(0.0, weightedInputs);
+        }
+
+        inputPtr = layerOutputs;
+        lastInputs = lrSz;
+    }
+
+    return inputPtr;
+}
+
+void NeuralNet::run(const double* inputs, std::vector<double>& outputs, double* trace, size_t firstLayer) const
+{
+    if(outputs.size() < layerSizes.back()) {
+        outputs.resize(layerSizes.back());
+    }
+    run(inputs, outputs.data(), trace, firstLayer);
+}
+
+void NeuralNet::run(const double* inputs, double* outputs, double* trace, size_t firstLayer) const
+{
+    assert(firstLayer < layerSizes.size());
+
+    size_t traceBegin = 0;
+    for(size_t lrIdx = 0; lrIdx + 1 < firstLayer; ++lrIdx) {
+        traceBegin += layerSizes[lrIdx];
+    }
+
+    auto inputPtr = firstLayer ? trace + traceBegin : inputs;
+    auto lastInputs = firstLayer ? layerSizes[firstLayer - 1] : nInputs;
+    if(firstLayer) {
+        traceBegin += lastInputs;
+    }
+    size_t weightsBegin = getLayerWeightsBegin(firstLayer);
+    for(size_t lrIdx = firstLayer; lrIdx < layerSizes.size(); ++lrIdx) {
+        const auto lrSz = layerSizes[lrIdx];
+        const bool isOutputLayer = (lrIdx == layerSizes.size() - 1);
+        const bool linearOutput = isOutputLayer && outputLinear;
+        double* layerOutputs = isOutputLayer ? outputs : trace + traceBegin;
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            auto weightedInputs = weights[weightsBegin++];
+            for(size_t w = 0; w < lastInputs; ++w) {
+                weightedInputs += weights[weightsBegin++] * inputPtr[w];
+            }
+            layerOutputs[neuIdx] = linearOutput ? weightedInputs : std::max(0.0, weightedInputs);
+        }
+
+        inputPtr = layerOutputs;
+        traceBegin += lrSz;
+        lastInputs = lrSz;
+    }
+}
+
+void NeuralNet::Workspace::reserve(const NeuralNet& nn)
+{
+    if(fits(nn)) {
+        return;
+    }
+    const auto perLine = alignment / sizeof(double);
+    const auto maxLayer = *std::max_element(nn.layerSizes.cbegin(), nn.layerSizes.cend());
+    stride = (maxLayer + perLine - 1) / perLine * perLine;
+
+    // Over-allocate by one cache line and start at the first aligned element
+    storage.assign(2 * stride + perLine, 0);
+    auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+    address = (address + alignment - 1) / alignment * alignment;
+    data = reinterpret_cast<double*>(address);
+}
+
+bool NeuralNet::Workspace::fits(const NeuralNet& nn) const
+{
+    for(const auto lrSz : nn.layerSizes) {
+        if(lrSz > stride) {
+            return false;
+        }
+    }
+    return true;
+}
+
+NeuralNet::Workspace& NeuralNet::Workspace::local(const NeuralNet& nn)
+{
+    thread_local Workspace ws;
+    ws.reserve(nn);
+    return ws;
+}
+
+size_t NeuralNet::getTraceSize() const
+{
+    size_t size = 0;
+    for(size_t lrIdx = 0; lrIdx + 1 < layerSizes.size(); ++lrIdx) {
+        size += layerSizes[lrIdx];
+    }
+    return size;
+}
+
+size_t NeuralNet::getLayerWeightsBegin(size_t layer) const
+{
+    size_t begin = 0;
+    auto lastInputs = nInputs;
+    for(size_t lrIdx = 0; lrIdx < layer; ++lrIdx) {
+        begin += (1 + lastInputs) * layerSizes[lrIdx];
+        lastInputs = layerSizes[lrIdx];
+    }
+    return begin;
+}
+
+double NeuralNet::backprop(const double* inputs, const double* targets,
+                           std::vector<double>& gradients, std::vector<double>& scratch) const
+{
+    size_t nNeurons = 0;
+    for(const auto lrSz : layerSizes) {
+        nNeurons += lrSz;
+    }
+    if(scratch.size() < nNeurons * 2) {
+        scratch.resize(nNeurons * 2);
+    }
+    if(gradients.size() != weights.size()) {
+        gradients.assign(weights.size(), 0);
+    }
+    double* activations = scratch.data();
+    double* deltas = activations + nNeurons;
+
+    // Forward pass keeping every layer's activations
+    auto inputPtr = inputs;
+    auto lastInputs = nInputs;
+    size_t weightsBegin = 0;
+    size_t actBegin = 0;
+    for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+        const auto lrSz = layerSizes[lrIdx];
+        const bool linearOutput = (lrIdx == layerSizes.size() - 1) && outputLinear;
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            auto weightedInputs = weights[weightsBegin++];
+            for(size_t w = 0; w < lastInputs; ++w) {
+                weightedInputs += weights[weightsBegin++] * inputPtr[w];
+            }
+            activations[actBegin + neuIdx] = linearOutput ? weightedInputs : std::max(0.0, weightedInputs);
+        }
+        inputPtr = activations + actBegin;
+        actBegin += lrSz;
+        lastInputs = lrSz;
+    }
+
+    // Output error; the ReLU derivative is 1 exactly where the activation is positive
+    double loss = 0;
+    const auto outSz = layerSizes.back();
+    const auto outBegin = nNeurons - outSz;
+    for(size_t neuIdx = 0; neuIdx < outSz; ++neuIdx) {
+        const auto diff = activations[outBegin + neuIdx] - targets[neuIdx];
+        loss += 0.5 * diff * diff;
+        deltas[outBegin + neuIdx] = (outputLinear || activations[outBegin + neuIdx] > 0) ? diff : 0;
+    }
+
+    // Backward pass, walking the flat weights from the end
+    size_t weightsEnd = weights.size();
+    size_t actEnd = nNeurons;
+    for(size_t lrIdx = layerSizes.size(); lrIdx-- > 0;) {
+        const auto lrSz = layerSizes[lrIdx];
+        const auto inSz = lrIdx ? layerSizes[lrIdx - 1] : nInputs;
+        const auto lrActBegin = actEnd - lrSz;
+        const auto lrWeightsBegin = weightsEnd - lrSz * (1 + inSz);
+
+        const double* layerInputs = lrIdx ? activations + lrActBegin - inSz : inputs;
+        double* inputDeltas = lrIdx ? deltas + lrActBegin - inSz : nullptr;
+        if(inputDeltas) {
+            std::fill(inputDeltas, inputDeltas + inSz, 0.0);
+        }
+
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            const auto delta = deltas[lrActBegin + neuIdx];
+            const auto wOffset = lrWeightsBegin + neuIdx * (1 + inSz);
+            const double* w = &weights[wOffset];
+            double* g = &gradients[wOffset];
+            g[0] += delta;
+            for(size_t k = 0; k < inSz; ++k) {
+                g[1 + k] += delta * layerInputs[k];
+            }
+            if(inputDeltas) {
+                for(size_t k = 0; k < inSz; ++k) {
+                    inputDeltas[k] += w[1 + k] * delta;
+                }
+            }
+        }
+
+        if(inputDeltas) {
+            for(size_t k = 0; k < inSz; ++k) {
+                if(layerInputs[k] <= 0) {
+                    inputDeltas[k] = 0;
+                }
+            }
+        }
+
+        actEnd = lrActBegin;
+        weightsEnd = lrWeightsBegin;
+    }
+
+    return loss;
+}
@@ -0,0 +1,257 @@
+#include "neuralnet/quantized.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// The SIMD kernels are compiled for their instruction sets whatever the build
+// flags, and picked at runtime from what the CPU supports
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define QUANTIZED_X86_KERNELS 1
+#endif
+
+namespace {
+
+const size_t blockSize = 32;
+
+int32_t dotScalar(const uint8_t* x, const int8_t* w, size_t n)
+{
+    int32_t acc = 0;
+    for(size_t i = 0; i < n; ++i) {
+        acc += static_cast<int32_t>(x[i]) * static_cast<int32_t>(w[i]);
+    }
+    return acc;
+}
+
+#ifdef QUANTIZED_X86_KERNELS
+__attribute__((target("avx2"))) int32_t horizontalSum(__m256i v)
+{
+    const auto s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    const auto h = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtsi128_si32(_mm_add_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+__attribute__((target("avx2"))) int32_t dotAvx2(const uint8_t* x, const int8_t* w, size_t n)
+{
+    // vpmaddubsw can saturate for u8 * s8 pairs, so widen to 16 bits and use vpmaddwd
+    __m256i acc = _mm256_setzero_si256();
+    for(size_t i = 0; i < n; i += 16) {
+        const auto xv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        const auto wv = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(xv, wv));
+    }
+    return horizontalSum(acc);
+}
+
+__attribute__((target("avx2,avxvnni"))) int32_t dotAvxVnni(const uint8_t* x, const int8_t* w, size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    for(size_t i = 0; i < n; i += blockSize) {
+        const auto xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        const auto wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        acc = _mm256_dpbusd_avx_epi32(acc, xv, wv);
+    }
+    return horizontalSum(acc);
+}
+
+__attribute__((target("avx2,avx512f,avx512vl,avx512vnni"))) int32_t dotAvx512Vnni(const uint8_t* x, const int8_t* w,
+                                                                               size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    for(size_t i = 0; i < n; i += blockSize) {
+        const auto xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        const auto wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        acc = _mm256_dpbusd_epi32(acc, xv, wv);
+    }
+    return horizontalSum(acc);
+}
+#endif
+
+using DotFunction = int32_t (*)(const uint8_t* x, const int8_t* w, size_t n);
+
+DotFunction getDotFunction(DotKernel kernel)
+{
+    switch(kernel) {
+#ifdef QUANTIZED_X86_KERNELS
+    case DotKernel::Avx2: return dotAvx2;
+    case DotKernel::AvxVnni: return dotAvxVnni;
+    case DotKernel::Avx512Vnni: return dotAvx512Vnni;
+#endif
+    default: return dotScalar;
+    }
+}
+
+// The best kernel of this CPU, picked once
+int32_t dot(const uint8_t* x, const int8_t* w, size_t n)
+{
+    static const auto function = getDotFunction(getSupportedDotKernels().back());
+    return function(x, w, n);
+}
+
+uint8_t quantize(double v, double invScale, uint8_t zeroPoint)
+{
+    const auto q = std::nearbyint(v * invScale) + zeroPoint;
+    return static_cast<uint8_t>(std::min(255.0, std::max(0.0, q)));
+}
+
+}
+
+std::vector<DotKernel> getSupportedDotKernels()
+{
+    std::vector<DotKernel> kernels{ DotKernel::Scalar };
+#ifdef QUANTIZED_X86_KERNELS
+    if(__builtin_cpu_supports("avx2")) {
+        kernels.push_back(DotKernel::Avx2);
+        if(__builtin_cpu_supports("avxvnni")) {
+            kernels.push_back(DotKernel::AvxVnni);
+        }
+        if(__builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512vl")) {
+            kernels.push_back(DotKernel::Avx512Vnni);
+        }
+    }
+#endif
+    return kernels;
+}
+
+int32_t quantizedDot(const uint8_t* x, const int8_t* w, size_t n, DotKernel kernel)
+{
+    assert(n % blockSize == 0);
+    return getDotFunction(kernel)(x, w, n);
+}
+
+QuantizedNet::QuantizedNet(const NeuralNet& nn, const double* calibrationInputs, size_t nSamples)
+    : outputLinear{ nn.isOutputLinear() }
+{
+    const auto& layerSizes = nn.getLayerSizes();
+    const auto& weights = nn.getWeights();
+
+    // Calibration: largest magnitude seen at each layer's inputs
+    std::vector<double> maxInput(layerSizes.size(), 0);
+    std::vector<double> trace(nn.getTraceSize());
+    std::vector<double> outputs;
+    for(size_t s = 0; s < nSamples; ++s) {
+        const auto inputs = calibrationInputs + s * nn.getInputs();
+        nn.run(inputs, outputs, trace.data());
+        for(size_t k = 0; k < nn.getInputs(); ++k) {
+            maxInput[0] = std::max(maxInput[0], std::fabs(inputs[k]));
+        }
+        size_t traceBegin = 0;
+        for(size_t lrIdx = 0; lrIdx + 1 < layerSizes.size(); ++lrIdx) {
+            for(size_t k = 0; k < layerSizes[lrIdx]; ++k) {
+                maxInput[lrIdx + 1] = std::max(maxInput[lrIdx + 1], trace[traceBegin + k]);
+            }
+            traceBegin += layerSizes[lrIdx];
+        }
+    }
+
+    size_t weightsBegin = 0;
+    auto lastInputs = nn.getInputs();
+    for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+        Layer layer;
+        layer.nInputs = lastInputs;
+        layer.nOutputs = layerSizes[lrIdx];
+        layer.stride = (lastInputs + blockSize - 1) / blockSize * blockSize;
+
+        // Net inputs may be negative and are shifted by 128; hidden inputs are ReLU outputs
+        const bool signedInput = (lrIdx == 0);
+        layer.inputZeroPoint = signedInput ? 128 : 0;
+        const auto inputRange = maxInput[lrIdx] > 0 ? maxInput[lrIdx] : 1.0;
+        layer.inputScale = inputRange / (signedInput ? 127 : 255);
+
+        double maxWeight = 0;
+        for(size_t neuIdx = 0; neuIdx < layer.nOutputs; ++neuIdx) {
+            for(size_t k = 0; k < lastInputs; ++k) {
+                maxWeight = std::max(maxWeight, std::fabs(weights[weightsBegin + neuIdx * (1 + lastInputs) + 1 + k]));
+            }
+        }
+        const auto weightScale = maxWeight > 0 ? maxWeight / 127 : 1.0;
+        layer.scale = weightScale * layer.inputScale;
+
+        layer.weights.assign(layer.nOutputs * layer.stride, 0);
+        layer.offsets.resize(layer.nOutputs);
+        for(size_t neuIdx = 0; neuIdx < layer.nOutputs; ++neuIdx) {
+            const auto bias = weights[weightsBegin++];
+            int32_t sum = 0;
+            for(size_t k = 0; k < lastInputs; ++k) {
+                const auto q = static_cast<int8_t>(std::nearbyint(weights[weightsBegin++] / weightScale));
+                layer.weights[neuIdx * layer.stride + k] = q;
+                sum += q;
+            }
+            layer.offsets[neuIdx] = bias - layer.scale * layer.inputZeroPoint * sum;
+        }
+
+        layers.push_back(std::move(layer));
+        lastInputs = layerSizes[lrIdx];
+    }
+}
+
+void QuantizedNet::run(const double* inputs, double* outputs, std::vector<uint8_t>& scratch) const
+{
+    size_t maxStride = 0;
+    for(const auto& layer : layers) {
+        maxStride = std::max(maxStride, std::max(layer.stride, layer.nOutputs));
+    }
+    if(scratch.size() < 2 * maxStride) {
+        scratch.assign(2 * maxStride, 0);
+    }
+    uint8_t* current = scratch.data();
+    uint8_t* next = current + maxStride;
+
+    // Padding entries meet zero weights, so their values do not matter
+    const auto& first = layers.front();
+    const auto invInputScale = 1 / first.inputScale;
+    for(size_t k = 0; k < first.nInputs; ++k) {
+        current[k] = quantize(inputs[k], invInputScale, first.inputZeroPoint);
+    }
+
+    for(size_t lrIdx = 0; lrIdx < layers.size(); ++lrIdx) {
+        const auto& layer = layers[lrIdx];
+        const bool isOutputLayer = (lrIdx == layers.size() - 1);
+        const auto invNextScale = isOutputLayer ? 0.0 : 1 / layers[lrIdx + 1].inputScale;
+        for(size_t neuIdx = 0; neuIdx < layer.nOutputs; ++neuIdx) {
+            const auto acc = dot(current, &layer.weights[neuIdx * layer.stride], layer.stride);
+            const auto y = layer.scale * acc + layer.offsets[neuIdx];
+            if(isOutputLayer) {
+                outputs[neuIdx] = outputLinear ? y : std::max(0.0, y);
+            }
+            else {
+                next[neuIdx] = quantize(std::max(0.0, y), invNextScale, 0);
+            }
+        }
+        std::swap(current, next);
+    }
+}
+
+size_t QuantizedNet::getMemoryBytes() const
+{
+    size_t bytes = 0;
+    for(const auto& layer : layers) {
+        bytes += layer.weights.size() * sizeof(int8_t) + layer.offsets.size() * sizeof(double) + sizeof(Layer);
+    }
+    return bytes;
+}
+
+QuantizationReport compareQuantized(const NeuralNet& nn, const QuantizedNet& quantized,
+                                    const double* inputs, size_t nSamples)
+{
+    QuantizationReport report{ nSamples, 0, 0, 0 };
+    std::vector<double> expected;
+    std::vector<double> actual(quantized.getOutputs());
+    std::vector<uint8_t> scratch;
+    double sumSq = 0;
+    for(size_t s = 0; s < nSamples; ++s) {
+        const auto row = inputs + s * nn.getInputs();
+        const auto resultIdx = nn.run(row, expected);
+        quantized.run(row, actual.data(), scratch);
+        for(size_t k = 0; k < actual.size(); ++k) {
+            const auto err = std::fabs(actual[k] - expected[resultIdx + k]);
+            report.maxAbsError = std::max(report.maxAbsError, err);
+            report.maxAbsOutput = std::max(report.maxAbsOutput, std::fabs(expected[resultIdx + k]));
+            sumSq += err * err;
+        }
+    }
+    const auto count = nSamples * actual.size();
+    report.rmsError = count ? std::sqrt(sumSq / count) : 0;
+    return report;
+}
@@ -0,0 +1,125 @@
+#include "neuralnet/sparse.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// Calls f(weight) for every connection weight of nn, skipping the biases
+template<typename NetType, typename F>
+void forEachConnection(NetType& nn, F f)
+{
+    auto& weights = nn.getWeights();
+    size_t index = 0;
+    auto lastInputs = nn.getInputs();
+    for(const auto lrSz : nn.getLayerSizes()) {
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            ++index;
+            for(size_t w = 0; w < lastInputs; ++w) {
+                f(weights[index++]);
+            }
+        }
+        lastInputs = lrSz;
+    }
+}
+
+}
+
+double getDensity(const NeuralNet& nn)
+{
+    size_t total = 0, nonZero = 0;
+    forEachConnection(nn, [&](const double& w) {
+        ++total;
+        nonZero += w != 0;
+    });
+    return total ? static_cast<double>(nonZero) / total : 1.0;
+}
+
+size_t pruneWeights(NeuralNet& nn, double threshold)
+{
+    size_t pruned = 0;
+    forEachConnection(nn, [&](double& w) {
+        if(w != 0 && std::fabs(w) < threshold) {
+            w = 0;
+            ++pruned;
+        }
+    });
+    return pruned;
+}
+
+size_t pruneToDensity(NeuralNet& nn, double density)
+{
+    std::vector<double> magnitudes;
+    forEachConnection(nn, [&](const double& w) { magnitudes.push_back(std::fabs(w)); });
+    const auto keep = static_cast<size_t>(std::floor(std::max(0.0, density) * magnitudes.size()));
+    if(keep >= magnitudes.size()) {
+        return 0;
+    }
+    // Weights strictly above the cut survive; ties at the cut are pruned with it
+    std::nth_element(magnitudes.begin(), magnitudes.begin() + (magnitudes.size() - keep - 1), magnitudes.end());
+    const auto cut = magnitudes[magnitudes.size() - keep - 1];
+    size_t pruned = 0;
+    forEachConnection(nn, [&](double& w) {
+        if(w != 0 && std::fabs(w) <= cut) {
+            w = 0;
+            ++pruned;
+        }
+    });
+    return pruned;
+}
+
+void SparseNet::assign(const NeuralNet& nn)
+{
+    nInputs = nn.getInputs();
+    layerSizes = nn.getLayerSizes();
+    outputLinear = nn.isOutputLinear();
+    biases.clear();
+    rowStarts.clear();
+    columns.clear();
+    values.clear();
+
+    const auto& weights = nn.getWeights();
+    size_t index = 0;
+    auto lastInputs = nInputs;
+    for(const auto lrSz : layerSizes) {
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx) {
+            biases.push_back(weights[index++]);
+            rowStarts.push_back(values.size());
+            for(size_t w = 0; w < lastInputs; ++w) {
+                const auto value = weights[index++];
+                if(value != 0) {
+                    columns.push_back(static_cast<uint32_t>(w));
+                    values.push_back(value);
+                }
+            }
+        }
+        lastInputs = lrSz;
+    }
+    rowStarts.push_back(values.size());
+}
+
+void SparseNet::run(const double* inputs, double* outputs, std::vector<double>& scratch) const
+{
+    const auto maxLayer = *std::max_element(layerSizes.cbegin(), layerSizes.cend());
+    if(scratch.size() < 2 * maxLayer) {
+        scratch.resize(2 * maxLayer);
+    }
+
+    const double* layerInputs = inputs;
+    size_t neuron = 0;
+    for(size_t lrIdx = 0; lrIdx < layerSizes.size(); ++lrIdx) {
+        const auto lrSz = layerSizes[lrIdx];
+        const bool isOutputLayer = (lrIdx == layerSizes.size() - 1);
+        const bool linearOutput = isOutputLayer && outputLinear;
+        double* layerOutputs = isOutputLayer ? outputs : scratch.data() + (lrIdx % 2) * maxLayer;
+        for(size_t neuIdx = 0; neuIdx < lrSz; ++neuIdx, ++neuron) {
+            auto weightedInputs = biases[neuron];
+            for(size_t k = rowStarts[neuron]; k < rowStarts[neuron + 1]; ++k) {
+                weightedInputs += values[k] * layerInputs[columns[k]];
+            }
+            layerOutputs[neuIdx] = linearOutput ? weightedInputs : std::max(0.0, weightedInputs);
+        }
+        layerInputs = layerOutputs;
+    }
+}
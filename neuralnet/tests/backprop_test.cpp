@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/neuralnet.h"
+
+#include <random>
+
+namespace {
+
+double loss(const NeuralNet& nn, const double* inputs, const double* targets)
+{
+    std::vector<double> outputs;
+    const auto resultIdx = nn.run(inputs, outputs);
+    double sum = 0;
+    for(size_t i = 0; i < nn.getLayerSizes().back(); ++i) {
+        const auto diff = outputs[resultIdx + i] - targets[i];
+        sum += 0.5 * diff * diff;
+    }
+    return sum;
+}
+
+// Compares the backprop gradient of nn, given random weights, with central differences
+void gradientMatchesFiniteDifferences(NeuralNet& nn)
+{
+    std::default_random_engine engine(11);
+    std::normal_distribution<double> gauss(0, 1);
+    for(auto& w : nn.getWeights()) {
+        w = gauss(engine);
+    }
+    std::vector<double> inputs(nn.getInputs()), targets(nn.getLayerSizes().back());
+    for(auto& x : inputs) {
+        x = gauss(engine);
+    }
+    for(auto& t : targets) {
+        t = gauss(engine);
+    }
+
+    std::vector<double> gradients, scratch;
+    const auto l = nn.backprop(inputs.data(), targets.data(), gradients, scratch);
+    REQUIRE(l == Approx(loss(nn, inputs.data(), targets.data())));
+
+    const double h = 1e-6;
+    for(size_t i = 0; i < nn.getWeights().size(); ++i) {
+        const auto w = nn.getWeights()[i];
+        nn.getWeights()[i] = w + h;
+        const auto up = loss(nn, inputs.data(), targets.data());
+        nn.getWeights()[i] = w - h;
+        const auto down = loss(nn, inputs.data(), targets.data());
+        nn.getWeights()[i] = w;
+        REQUIRE(gradients[i] == Approx((up - down) / (2 * h)).margin(1e-6));
+    }
+}
+
+}
+
+TEST_CASE( "Backprop of a single linear neuron", "[backprop]" ) {
+    NeuralNet nn(1, {1}, true);
+    nn.setWeights({ 1, 2 });
+    std::vector<double> gradients, scratch;
+    const double input = 3;
+    const double target = 4;
+    // output 7, error 3
+    REQUIRE(nn.backprop(&input, &target, gradients, scratch) == 4.5);
+    REQUIRE(gradients[0] == 3);
+    REQUIRE(gradients[1] == 9);
+}
+
+TEST_CASE( "Backprop gradient matches finite differences", "[backprop]" ) {
+    for(const bool linear : { false, true }) {
+        NeuralNet nn(2, {4, 3, 2}, linear);
+        gradientMatchesFiniteDifferences(nn);
+    }
+}
+
+TEST_CASE( "Backprop gradient matches with more inputs than outputs", "[backprop]" ) {
+    // With as many inputs as outputs, a miscounted weight layout can cancel out
+    NeuralNet nn(3, {2, 1}, false);
+    REQUIRE(nn.getWeights().size() == 2 * (1 + 3) + 1 * (1 + 2));
+    gradientMatchesFiniteDifferences(nn);
+
+    NeuralNet wide(5, {3, 4, 2}, true);
+    gradientMatchesFiniteDifferences(wide);
+}
+
+TEST_CASE( "Backprop accumulates over samples", "[backprop]" ) {
+    NeuralNet nn(1, {2, 1}, true);
+    nn.setWeights({ 1, 2, 3, 4, 5, 6, 7 });
+    std::vector<double> once, twice, scratch;
+    const double input = 0.5;
+    const double target = 1;
+    nn.backprop(&input, &target, once, scratch);
+    nn.backprop(&input, &target, twice, scratch);
+    nn.backprop(&input, &target, twice, scratch);
+    for(size_t i = 0; i < once.size(); ++i) {
+        REQUIRE(twice[i] == Approx(2 * once[i]));
+    }
+}
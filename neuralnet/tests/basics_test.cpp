@@ -2,6 +2,8 @@
 
 #include "neuralnet/neuralnet.h"
 
+#include <cstdint>
+
 TEST_CASE( "Neural net weights have expected number", "[neuralnet]" ) {
     NeuralNet nn(2, {2, 3, 2});
     REQUIRE(nn.getWeights().size() == 23);
@@ -96,3 +98,85 @@ TEST_CASE( "1-dimensional function, 1 hidden layer", "[neuralnet]" ) {
     const auto result = nn.run(inputs, outputs);
     REQUIRE(outputs[result] == 72);
 }
+
+TEST_CASE( "Traced run matches plain run", "[neuralnet]" ) {
+    NeuralNet nn(2, {3, 4, 2}, true);
+    double v = 0.1;
+    for(auto& w : nn.getWeights()) {
+        w = v;
+        v = -v * 1.1 + 0.05;
+    }
+    REQUIRE(nn.getTraceSize() == 7);
+    REQUIRE(nn.getLayerWeightsBegin(0) == 0);
+    REQUIRE(nn.getLayerWeightsBegin(1) == 9);
+    REQUIRE(nn.getLayerWeightsBegin(2) == 25);
+
+    const double inputs[2] = {1.0, -2.0};
+    std::vector<double> outputs, tracedOutputs;
+    const auto result = nn.run(inputs, outputs);
+    std::vector<double> trace(nn.getTraceSize());
+    nn.run(inputs, tracedOutputs, trace.data());
+    REQUIRE(tracedOutputs[0] == outputs[result]);
+    REQUIRE(tracedOutputs[1] == outputs[result + 1]);
+}
+
+TEST_CASE( "Run resumed from a later layer only recomputes that layer on", "[neuralnet]" ) {
+    NeuralNet nn(1, {2, 2, 1}, true);
+    nn.setWeights({   0, 1,
+                      0, 2,
+
+                      0, 1, 1,
+                      0, 1, -1,
+
+                      1, 1, 1
+                  });
+    const double input = 1.0;
+    std::vector<double> outputs;
+    std::vector<double> trace(nn.getTraceSize());
+    nn.run(&input, outputs, trace.data());
+    // layer 0: 1, 2; layer 1: 3, 0; output: 4
+    REQUIRE(trace[2] == 3);
+    REQUIRE(outputs[0] == 4);
+
+    // Change the output layer only, inputs are then never read
+    nn.getWeights()[10] = 10;
+    nn.run(nullptr, outputs, trace.data(), 2);
+    REQUIRE(outputs[0] == 13);
+
+    // Change the second hidden layer
+    nn.getWeights()[4] = 1;
+    nn.run(nullptr, outputs, trace.data(), 1);
+    REQUIRE(trace[2] == 4);
+    REQUIRE(outputs[0] == 14);
+}
+
+TEST_CASE( "Workspace run matches plain run", "[neuralnet]" ) {
+    NeuralNet nn(2, {3, 4, 2}, true);
+    double v = 0.1;
+    for(auto& w : nn.getWeights()) {
+        w = v;
+        v = -v * 1.1 + 0.05;
+    }
+
+    const double inputs[2] = {1.0, -2.0};
+    std::vector<double> outputs;
+    const auto result = nn.run(inputs, outputs);
+    NeuralNet::Workspace ws(nn);
+    REQUIRE(ws.fits(nn));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ws.getOutputs()) % NeuralNet::Workspace::alignment == 0);
+    const auto wsOutputs = nn.run(inputs, ws);
+    REQUIRE(wsOutputs[0] == outputs[result]);
+    REQUIRE(wsOutputs[1] == outputs[result + 1]);
+}
+
+TEST_CASE( "Thread-local workspace grows to fit wider nets", "[neuralnet]" ) {
+    NeuralNet small(1, {2, 1});
+    NeuralNet wide(1, {100, 1});
+    auto& ws = NeuralNet::Workspace::local(small);
+    REQUIRE(ws.fits(small));
+    REQUIRE(!ws.fits(wide));
+    auto& again = NeuralNet::Workspace::local(wide);
+    REQUIRE(&again == &ws);
+    REQUIRE(ws.fits(wide));
+    REQUIRE(ws.fits(small));
+}
@@ -0,0 +1,20 @@
+#ifndef EXPORT_FIXTURE_H
+#define EXPORT_FIXTURE_H
+
+#include "neuralnet/neuralnet.h"
+
+#include <random>
+
+// Nets exported at build time by export_fixture and checked by export_test
+inline NeuralNet makeExportFixture(bool large)
+{
+    NeuralNet nn(3, large ? std::vector<size_t>{80, 60, 2} : std::vector<size_t>{16, 8, 2}, !large);
+    std::mt19937 engine(large ? 2 : 1);
+    std::normal_distribution<double> gauss(0, 1);
+    for(auto& w : nn.getWeights()) {
+        w = gauss(engine);
+    }
+    return nn;
+}
+
+#endif // EXPORT_FIXTURE_H
@@ -0,0 +1,20 @@
+#include "neuralnet/codegen.h"
+
+#include "export_fixture.h"
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    if(argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <small net header> <large net header>\n";
+        return 1;
+    }
+
+    std::ofstream small(argv[1]);
+    writeInferenceHeader(small, makeExportFixture(false), "exported_small");
+    std::ofstream large(argv[2]);
+    writeInferenceHeader(large, makeExportFixture(true), "exported_large");
+    return (small && large) ? 0 : 1;
+}
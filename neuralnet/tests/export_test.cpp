@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/codegen.h"
+
+#include "export_fixture.h"
+#include "exported_small.h"
+#include "exported_large.h"
+
+#include <sstream>
+
+namespace {
+
+template<typename Infer>
+void requireSameAsRun(const NeuralNet& nn, Infer infer)
+{
+    std::vector<double> expected;
+    double actual[2];
+    for(int i = 0; i < 50; ++i) {
+        const double inputs[3] = { 0.04 * i - 1, 0.5 - 0.02 * i, 0.01 * i * i - 1 };
+        const auto e = nn.run(inputs, expected);
+        infer(inputs, actual);
+        REQUIRE(actual[0] == expected[e]);
+        REQUIRE(actual[1] == expected[e + 1]);
+    }
+}
+
+}
+
+TEST_CASE( "Exported header describes the topology", "[export]" ) {
+    REQUIRE(exported_small::numInputs == 3);
+    REQUIRE(exported_small::numOutputs == 2);
+    REQUIRE(sizeof(exported_small::weights) / sizeof(double) == makeExportFixture(false).getWeights().size());
+}
+
+TEST_CASE( "Exported weights are bit-exact", "[export]" ) {
+    const auto nn = makeExportFixture(false);
+    for(size_t i = 0; i < nn.getWeights().size(); ++i) {
+        REQUIRE(exported_small::weights[i] == nn.getWeights()[i]);
+    }
+}
+
+TEST_CASE( "Exported unrolled infer matches NeuralNet::run", "[export]" ) {
+    requireSameAsRun(makeExportFixture(false), exported_small::infer);
+}
+
+TEST_CASE( "Exported looped infer matches NeuralNet::run", "[export]" ) {
+    requireSameAsRun(makeExportFixture(true), exported_large::infer);
+}
+
+TEST_CASE( "Exported header is self-contained", "[export]" ) {
+    std::ostringstream os;
+    writeInferenceHeader(os, makeExportFixture(false), "net");
+    const auto src = os.str();
+    REQUIRE(src.find("#include <cstddef>") != std::string::npos);
+    REQUIRE(src.find("#include \"") == std::string::npos);
+    REQUIRE(src.find("namespace net {") != std::string::npos);
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/graphgenome.h"
+#include "neuralnet/neuralnet.h"
+
+TEST_CASE( "Minimal graph genome connects inputs to outputs", "[graphgenome]" ) {
+    GraphGenome genome(2, 1, true);
+    REQUIRE(genome.getNumNodes() == 3);
+    REQUIRE(genome.getConnections().size() == 2);
+
+    auto& weights = genome.getWeights();
+    weights[genome.getBiasIndex(2)] = 0.5;
+    weights[genome.getConnections()[0].weight] = 2;
+    weights[genome.getConnections()[1].weight] = -1;
+
+    std::vector<double> scratch;
+    double output;
+    const double inputs[2] = { 1.5, 4 };
+    genome.run(inputs, &output, scratch);
+    REQUIRE(output == Approx(0.5 + 3 - 4));
+}
+
+TEST_CASE( "Connections that would close a cycle are rejected", "[graphgenome]" ) {
+    GraphGenome genome(1, 1);
+    const auto a = genome.addNode(0);
+    const auto b = genome.addNode(genome.getConnections().size() - 1);
+    REQUIRE(genome.canConnect(a, b) == false); // exists already
+    REQUIRE(genome.canConnect(b, a) == false);
+    REQUIRE(genome.canConnect(1, a) == false);
+    REQUIRE(genome.canConnect(a, 0) == false);
+    REQUIRE(genome.canConnect(0, b));
+    genome.addConnection(0, b, 1);
+    REQUIRE(genome.canConnect(0, b) == false);
+}
+
+TEST_CASE( "Splitting a connection keeps the outputs", "[graphgenome]" ) {
+    GraphGenome genome(1, 1, true);
+    genome.getWeights()[genome.getConnections()[0].weight] = -0.75;
+    genome.getWeights()[genome.getBiasIndex(1)] = 0.25;
+
+    std::vector<double> scratch;
+    double before, after;
+    const double input = 2;
+    genome.run(&input, &before, scratch);
+    const auto node = genome.addNode(0);
+    REQUIRE(node == 2);
+    REQUIRE(!genome.getConnections()[0].enabled);
+    genome.run(&input, &after, scratch);
+    REQUIRE(after == Approx(before));
+}
+
+TEST_CASE( "Graph genome of a layered topology matches NeuralNet", "[graphgenome]" ) {
+    // 2-3-1 net built from the minimal genome: split the direct connections into
+    // hidden nodes, then wire the hidden layer densely
+    NeuralNet nn(2, {3, 1}, true);
+    nn.setWeights({ 0.1, 1, -2,   -0.3, 0.5, 0.5,   0.2, -1, -1,
+                    0.05, 1.5, -0.5, 2 });
+
+    GraphGenome genome(2, 1, true);
+    const auto h0 = genome.addNode(0);
+    const auto h1 = genome.addNode(1);
+    genome.addConnection(1, h0, 0);
+    genome.addConnection(0, h1, 0);
+    genome.setEnabled(0, true);
+    const auto h2 = genome.addNode(0);
+    genome.addConnection(1, h2, 0);
+
+    auto& weights = genome.getWeights();
+    const auto setWeight = [&](size_t from, size_t to, double w) {
+        for(const auto& c : genome.getConnections()) {
+            if(c.enabled && c.from == from && c.to == to) {
+                weights[c.weight] = w;
+            }
+        }
+    };
+    const size_t hidden[3] = { h0, h1, h2 };
+    const auto& nnWeights = nn.getWeights();
+    for(size_t h = 0; h < 3; ++h) {
+        weights[genome.getBiasIndex(hidden[h])] = nnWeights[h * 3];
+        setWeight(0, hidden[h], nnWeights[h * 3 + 1]);
+        setWeight(1, hidden[h], nnWeights[h * 3 + 2]);
+        setWeight(hidden[h], 2, nnWeights[10 + h]);
+    }
+    weights[genome.getBiasIndex(2)] = nnWeights[9];
+
+    std::vector<double> outputs, scratch;
+    for(const double x : { -1.0, 0.0, 0.5, 2.0 }) {
+        const double inputs[2] = { x, 1 - x };
+        const auto result = nn.run(inputs, outputs);
+        double actual;
+        genome.run(inputs, &actual, scratch);
+        REQUIRE(actual == Approx(outputs[result]));
+    }
+}
+
+TEST_CASE( "Plan is compiled once per structural change", "[graphgenome]" ) {
+    GraphGenome genome(1, 1);
+    std::vector<double> scratch;
+    double output;
+    const double input = 1;
+    genome.run(&input, &output, scratch);
+    genome.getWeights()[0] = 1;
+    genome.run(&input, &output, scratch);
+    REQUIRE(output == 1);
+    REQUIRE(genome.getCompilations() == 1);
+
+    genome.addNode(0);
+    genome.run(&input, &output, scratch);
+    genome.run(&input, &output, scratch);
+    REQUIRE(genome.getCompilations() == 2);
+
+    const auto copy = genome;
+    copy.run(&input, &output, scratch);
+    REQUIRE(copy.getCompilations() == 2);
+}
+
+TEST_CASE( "Nodes that reach no output are left out of the plan", "[graphgenome]" ) {
+    GraphGenome genome(1, 1, true);
+    const auto node = genome.addNode(0);
+    genome.setEnabled(0, true);
+    REQUIRE(genome.compile().getNumSteps() == 2);
+    REQUIRE(genome.compile().getNumOps() == 3);
+
+    // Without its outgoing connection the hidden node is dead
+    genome.setEnabled(genome.getConnections().size() - 1, false);
+    REQUIRE(genome.compile().getNumSteps() == 1);
+    REQUIRE(genome.getCompilations() == 2);
+
+    std::vector<double> scratch;
+    double output;
+    const double input = 3;
+    genome.getWeights()[genome.getConnections()[0].weight] = 0.5;
+    genome.getWeights()[genome.getBiasIndex(node)] = 100;
+    genome.run(&input, &output, scratch);
+    REQUIRE(output == 1.5);
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/interleaved.h"
+
+#include <random>
+
+TEST_CASE( "Interleaved nets match individual runs exactly", "[interleaved]" ) {
+    std::mt19937 engine(11);
+    std::normal_distribution<double> gauss(0, 1);
+    for(const bool linear : { true, false }) {
+        std::vector<NeuralNet> nets(5, NeuralNet(3, {6, 4, 2}, linear));
+        std::vector<const NeuralNet*> ptrs;
+        for(auto& nn : nets) {
+            for(auto& w : nn.getWeights()) {
+                w = gauss(engine);
+            }
+            ptrs.push_back(&nn);
+        }
+
+        InterleavedNets lanes;
+        lanes.load(ptrs.data(), ptrs.size());
+        REQUIRE(lanes.size() == 5);
+
+        std::vector<double> outputs;
+        for(int s = 0; s < 10; ++s) {
+            const double inputs[3] = { gauss(engine), gauss(engine), gauss(engine) };
+            const auto batched = lanes.run(inputs);
+            // Exact only because the library is built with -ffp-contract=off
+            for(size_t i = 0; i < nets.size(); ++i) {
+                const auto result = nets[i].run(inputs, outputs);
+                REQUIRE(batched[i] == outputs[result]);
+                REQUIRE(batched[InterleavedNets::maxLanes + i] == outputs[result + 1]);
+            }
+        }
+    }
+}
+
+TEST_CASE( "Interleaved nets can be reloaded with another topology", "[interleaved]" ) {
+    NeuralNet a(1, {1}, true);
+    a.setWeights({ 1, 2 });
+    NeuralNet b(2, {1}, true);
+    b.setWeights({ 0, 1, 1 });
+
+    InterleavedNets lanes;
+    const NeuralNet* first = &a;
+    lanes.load(&first, 1);
+    const double x = 3;
+    REQUIRE(lanes.run(&x)[0] == 7);
+
+    const NeuralNet* second = &b;
+    lanes.load(&second, 1);
+    const double xy[2] = { 3, 4 };
+    REQUIRE(lanes.run(xy)[0] == 7);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/codegen.h"
+#include "neuralnet/jit.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <sstream>
+
+namespace {
+
+void randomize(NeuralNet& nn, unsigned int seed)
+{
+    std::default_random_engine engine(seed);
+    std::normal_distribution<double> gauss(0, 1);
+    for(auto& w : nn.getWeights()) {
+        w = gauss(engine);
+    }
+}
+
+std::string testCacheDir()
+{
+    return (std::filesystem::temp_directory_path() / "evolvenn_jit_test").string();
+}
+
+}
+
+TEST_CASE( "Topology key ignores the weights", "[jit]" ) {
+    NeuralNet a(1, {8, 8, 1}, true), b(1, {8, 8, 1}, true), c(1, {8, 8, 1}, false);
+    randomize(a, 1);
+    REQUIRE(getTopologyKey(a) == getTopologyKey(b));
+    REQUIRE(getTopologyKey(a) != getTopologyKey(c));
+}
+
+TEST_CASE( "Generated source defines the forward function", "[jit]" ) {
+    NeuralNet nn(2, {3, 1});
+    std::ostringstream os;
+    writeForwardFunction(os, nn, "my_forward");
+    REQUIRE(os.str().find("extern \"C\" void my_forward(") != std::string::npos);
+}
+
+TEST_CASE( "JIT forward pass matches NeuralNet::run exactly", "[jit]" ) {
+    JitCompiler jit(testCacheDir());
+    for(const bool linear : { true, false }) {
+        // Second topology is over the unroll limit and uses the loop form
+        for(const auto& layers : { std::vector<size_t>{8, 8, 1}, std::vector<size_t>{64, 64, 3} }) {
+            NeuralNet nn(2, layers, linear);
+            randomize(nn, 5);
+            if(!jit.get(nn)) {
+                WARN("no compiler available, JIT falls back to NeuralNet::run");
+            }
+
+            std::vector<double> expected, actual;
+            for(int i = 0; i < 20; ++i) {
+                const double inputs[2] = { 0.1 * i - 1, 0.05 * i };
+                const auto e = nn.run(inputs, expected);
+                const auto a = jit.run(nn, inputs, actual);
+                for(size_t k = 0; k < layers.back(); ++k) {
+                    REQUIRE(actual[a + k] == expected[e + k]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE( "JIT cache defaults to the per-user cache directory", "[jit]" ) {
+    const auto previous = std::getenv("XDG_CACHE_HOME");
+    const std::string saved = previous ? previous : "";
+    setenv("XDG_CACHE_HOME", "/some/cache", 1);
+    REQUIRE(JitCompiler::getDefaultCacheDir() == "/some/cache/evolvenn_jit");
+    if(previous) {
+        setenv("XDG_CACHE_HOME", saved.c_str(), 1);
+    }
+    else {
+        unsetenv("XDG_CACHE_HOME");
+    }
+}
+
+TEST_CASE( "JIT loads nothing that others could have written", "[jit]" ) {
+    namespace fs = std::filesystem;
+    NeuralNet nn(2, {4, 1}, true);
+    randomize(nn, 7);
+    const double inputs[2] = { 0.3, -0.2 };
+    std::vector<double> expected, actual;
+    const auto e = nn.run(inputs, expected);
+
+    const auto dir = fs::temp_directory_path() / "evolvenn_jit_perm_test";
+    fs::remove_all(dir);
+    {
+        JitCompiler jit(dir.string());
+        if(!jit.get(nn)) {
+            WARN("no compiler available, cannot check loading");
+            fs::remove_all(dir);
+            return;
+        }
+    }
+
+    // A library others may write to could have been replaced
+    for(const auto& entry : fs::directory_iterator(dir)) {
+        fs::permissions(entry.path(), fs::perms::group_write, fs::perm_options::add);
+    }
+    {
+        JitCompiler jit(dir.string());
+        REQUIRE(!jit.get(nn));
+        const auto a = jit.run(nn, inputs, actual);
+        REQUIRE(actual[a] == expected[e]);
+    }
+
+    // So could anything in a directory others may write to
+    fs::permissions(dir, fs::perms::others_write, fs::perm_options::add);
+    for(const auto& entry : fs::directory_iterator(dir)) {
+        fs::permissions(entry.path(), fs::perms::group_write, fs::perm_options::remove);
+    }
+    {
+        JitCompiler jit(dir.string());
+        REQUIRE(!jit.get(nn));
+    }
+    fs::remove_all(dir);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/quantized.h"
+
+#include <random>
+
+namespace {
+
+NeuralNet makeRandomNet(size_t nInputs, const std::vector<size_t>& layers, bool linear, unsigned int seed)
+{
+    NeuralNet nn(nInputs, layers, linear);
+    std::mt19937 engine(seed);
+    std::normal_distribution<double> gauss(0, 0.5);
+    for(auto& w : nn.getWeights()) {
+        w = gauss(engine);
+    }
+    return nn;
+}
+
+std::vector<double> makeInputs(size_t nInputs, size_t nSamples, unsigned int seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<double> inputs(nInputs * nSamples);
+    for(auto& x : inputs) {
+        x = uniform(engine);
+    }
+    return inputs;
+}
+
+}
+
+TEST_CASE( "Quantized net tracks the double net closely", "[quantized]" ) {
+    for(const bool linear : { true, false }) {
+        const auto nn = makeRandomNet(4, {40, 40, 3}, linear, 3);
+        const auto calibration = makeInputs(4, 200, 1);
+        QuantizedNet q(nn, calibration.data(), 200);
+        REQUIRE(q.getInputs() == 4);
+        REQUIRE(q.getOutputs() == 3);
+
+        const auto test = makeInputs(4, 500, 2);
+        const auto report = compareQuantized(nn, q, test.data(), 500);
+        REQUIRE(report.samples == 500);
+        REQUIRE(report.maxAbsOutput > 0);
+        REQUIRE(report.rmsError < 0.02 * report.maxAbsOutput);
+        REQUIRE(report.maxAbsError < 0.1 * report.maxAbsOutput);
+    }
+}
+
+TEST_CASE( "Quantized net is exact for representable weights", "[quantized]" ) {
+    // Weights on the int8 grid and inputs on the calibrated grid leave only rounding-free arithmetic
+    NeuralNet nn(1, {2, 1}, true);
+    nn.setWeights({   0.5, 127,
+                      0, -127,
+
+                      1, 1, 1
+                  });
+    const double calibration[2] = { -1, 1 };
+    QuantizedNet q(nn, calibration, 2);
+    std::vector<uint8_t> scratch;
+    double output = 0;
+    const double input = 1;
+    q.run(&input, &output, scratch);
+    std::vector<double> expected;
+    const auto resultIdx = nn.run(&input, expected);
+    REQUIRE(output == Approx(expected[resultIdx]).epsilon(0.01));
+}
+
+TEST_CASE( "Quantized weights take an eighth of the memory", "[quantized]" ) {
+    const auto nn = makeRandomNet(64, {256, 256, 1}, true, 4);
+    const auto calibration = makeInputs(64, 10, 5);
+    QuantizedNet q(nn, calibration.data(), 10);
+    REQUIRE(q.getMemoryBytes() < nn.getWeights().size() * sizeof(double) / 4);
+}
+
+TEST_CASE( "Inputs beyond the calibrated range saturate", "[quantized]" ) {
+    NeuralNet nn(1, {1}, true);
+    nn.setWeights({ 0, 1 });
+    const double calibration[1] = { 1 };
+    QuantizedNet q(nn, calibration, 1);
+    std::vector<uint8_t> scratch;
+    double output = 0;
+    const double input = 5;
+    q.run(&input, &output, scratch);
+    REQUIRE(output == Approx(1));
+}
+
+TEST_CASE( "Every supported dot kernel matches the scalar one", "[quantized]" ) {
+    std::mt19937 engine(21);
+    std::uniform_int_distribution<int> byte(0, 255);
+    const auto kernels = getSupportedDotKernels();
+    REQUIRE(kernels.front() == DotKernel::Scalar);
+    for(const size_t n : { 32, 64, 96, 512 }) {
+        std::vector<uint8_t> x(n);
+        std::vector<int8_t> w(n);
+        for(size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<uint8_t>(byte(engine));
+            w[i] = static_cast<int8_t>(byte(engine) - 128);
+        }
+        // Extremes, where a saturating 16-bit kernel would go wrong
+        x[0] = 255;
+        w[0] = -128;
+        x[1] = 255;
+        w[1] = -128;
+        const auto expected = quantizedDot(x.data(), w.data(), n, DotKernel::Scalar);
+        for(const auto kernel : kernels) {
+            REQUIRE(quantizedDot(x.data(), w.data(), n, kernel) == expected);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include <catch2/catch.hpp>
+
+#include "neuralnet/sparse.h"
+
+#include <random>
+
+namespace {
+
+NeuralNet makeRandomNet(unsigned int seed)
+{
+    NeuralNet nn(5, {20, 12, 3}, true);
+    std::mt19937 engine(seed);
+    std::normal_distribution<double> gauss(0, 1);
+    for(auto& w : nn.getWeights()) {
+        w = gauss(engine);
+    }
+    return nn;
+}
+
+}
+
+TEST_CASE( "Pruning zeroes small connection weights but not biases", "[sparse]" ) {
+    NeuralNet nn(2, {1}, true);
+    nn.setWeights({ 0.01, 0.05, -2 });
+    REQUIRE(getDensity(nn) == 1);
+    REQUIRE(pruneWeights(nn, 0.1) == 1);
+    REQUIRE(nn.getWeights() == std::vector<double>{ 0.01, 0, -2 });
+    REQUIRE(getDensity(nn) == 0.5);
+}
+
+TEST_CASE( "Pruning to a density keeps the largest weights", "[sparse]" ) {
+    auto nn = makeRandomNet(1);
+    pruneToDensity(nn, 0.25);
+    REQUIRE(getDensity(nn) <= 0.25);
+    REQUIRE(getDensity(nn) > 0.2);
+    REQUIRE(preferSparse(nn));
+    REQUIRE(!preferSparse(makeRandomNet(2)));
+}
+
+TEST_CASE( "Sparse net matches the dense run", "[sparse]" ) {
+    for(const double density : { 1.0, 0.5, 0.1, 0.0 }) {
+        auto nn = makeRandomNet(3);
+        pruneToDensity(nn, density);
+        const SparseNet sparse(nn);
+        REQUIRE(sparse.getNonZeros() == static_cast<size_t>(getDensity(nn) * (5 * 20 + 20 * 12 + 12 * 3) + 0.5));
+
+        std::vector<double> dense, scratch;
+        double outputs[3];
+        const double inputs[5] = { 0.5, -1, 2, 0.25, -0.75 };
+        const auto result = nn.run(inputs, dense);
+        sparse.run(inputs, outputs, scratch);
+        for(size_t k = 0; k < 3; ++k) {
+            REQUIRE(outputs[k] == Approx(dense[result + k]).margin(1e-12));
+        }
+    }
+}
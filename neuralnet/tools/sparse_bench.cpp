@@ -0,0 +1,54 @@
+// Forward pass time of the dense and the sparse path on one network pruned to
+// decreasing densities. Usage: sparse_bench [hidden size] [runs]
+
+#include "neuralnet/sparse.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+int main(int argc, char **argv)
+{
+    const size_t hidden = argc > 1 ? std::stoul(argv[1]) : 512;
+    const size_t runs = argc > 2 ? std::stoul(argv[2]) : 200;
+
+    NeuralNet nn(64, {hidden, hidden, 10}, true);
+    std::mt19937 engine(1);
+    std::normal_distribution<double> gauss(0, 1);
+    for(auto& w : nn.getWeights()) {
+        w = gauss(engine);
+    }
+    std::vector<double> inputs(64);
+    for(auto& x : inputs) {
+        x = gauss(engine);
+    }
+
+    std::cout << "64-" << hidden << "-" << hidden << "-10, " << nn.getWeights().size() << " weights\n";
+    NeuralNet::Workspace ws(nn);
+    std::vector<double> scratch;
+    std::vector<double> outputs(10);
+    double checksum = 0;
+    for(const double density : { 1.0, 0.5, 0.3, 0.2, 0.1, 0.05, 0.01 }) {
+        pruneToDensity(nn, density);
+
+        auto start = std::chrono::steady_clock::now();
+        for(size_t r = 0; r < runs; ++r) {
+            checksum += *nn.run(inputs.data(), ws);
+        }
+        const auto denseUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / runs;
+
+        const SparseNet sparse(nn);
+        start = std::chrono::steady_clock::now();
+        for(size_t r = 0; r < runs; ++r) {
+            sparse.run(inputs.data(), outputs.data(), scratch);
+            checksum += outputs[0];
+        }
+        const auto sparseUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / runs;
+
+        std::cout << "density " << getDensity(nn) << ": dense " << denseUs << " us, sparse " << sparseUs
+                  << " us" << (preferSparse(nn) ? " (sparse chosen)" : "") << "\n";
+    }
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
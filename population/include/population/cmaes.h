@@ -0,0 +1,61 @@
+#ifndef CMAES_H
+#define CMAES_H
+
+#include "population/population.h"
+
+#include <vector>
+#include <random>
+#include <unordered_map>
+
+// Covariance matrix adaptation evolution strategy (Hansen, "The CMA Evolution
+// Strategy: A Tutorial"). Candidates are drawn from N(mean, sigma^2 C) into the
+// individuals' genomes; the population size is used as lambda.
+// Separable mode only adapts the diagonal of C (sep-CMA-ES), which costs O(n)
+// instead of O(n^2) per candidate and suits large genomes.
+class CmaEs : public Strategy
+{
+public:
+    enum class Covariance { Full, Separable };
+
+    CmaEs(const std::vector<double>& initialMean, double initialSigma,
+          Covariance mode = Covariance::Full, unsigned int seed = 0);
+
+    void sample(PopulationVector& individuals) override;
+    void update(const PopulationVector& individuals) override;
+
+    const std::vector<double>& getMean() const { return mean; }
+    double getSigma() const { return sigma; }
+
+private:
+    void initParameters(size_t lambda);
+    void decompose();
+
+    size_t n;
+    Covariance mode;
+    std::vector<double> mean;
+    double sigma;
+    std::default_random_engine engine;
+
+    size_t lambda{ 0 };
+    size_t mu{ 0 };
+    std::vector<double> recombWeights;
+    double mueff{ 0 };
+    double cc{ 0 }, cs{ 0 }, c1{ 0 }, cmu{ 0 }, damps{ 0 }, chiN{ 0 };
+
+    // Full mode: C = B diag(D^2) B^T with B row-major n x n. Separable mode: C = diag(D^2).
+    std::vector<double> C;
+    std::vector<double> B;
+    std::vector<double> D;
+    std::vector<double> pc;
+    std::vector<double> ps;
+    size_t generation{ 0 };
+    size_t eigenGeneration{ 0 };
+
+    // Steps y = (x - mean) / sigma of this generation's candidates, one row each
+    std::vector<double> steps;
+    std::unordered_map<const Individual*, size_t> stepIndex;
+    std::vector<double> z;
+    std::vector<double> tmp;
+};
+
+#endif // CMAES_H
@@ -0,0 +1,48 @@
+#ifndef CROSSOVER_H
+#define CROSSOVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Recombination kernels writing child[0..n) from the genomes of parents a and b.
+// Random choices are hashed from the seed and the entry's position instead of
+// drawn from an engine, so the loops carry no state and children are reproducible.
+// child may be a or b.
+
+// Takes each entry from a or b with equal probability
+void uniformCrossover(const double* a, const double* b, double* child, size_t n, uint64_t seed);
+
+// Arithmetic blend a + alpha * (b - a); 0.5 gives the parents' mean
+void blendCrossover(const double* a, const double* b, double* child, size_t n, double alpha);
+
+// Takes whole segments from a or b with equal probability, e.g. the layers of a
+// network. Segment k is [bounds[k], bounds[k + 1]), so bounds holds nSegments + 1
+// ascending offsets.
+void segmentCrossover(const double* a, const double* b, double* child,
+                      const size_t* bounds, size_t nSegments, uint64_t seed);
+
+// Simulated binary crossover: each entry becomes one of the two children SBX
+// spreads around the parents' mean, with spread factor beta drawn for the
+// distribution index eta. Larger eta keeps children closer to their parents.
+// Betas are tabulated for quantized uniform draws, which leaves a table lookup
+// per entry.
+class SbxCrossover
+{
+public:
+    explicit SbxCrossover(double eta = 15);
+
+    void operator()(const double* a, const double* b, double* child, size_t n, uint64_t seed) const;
+
+    double getEta() const { return eta; }
+
+private:
+    static constexpr size_t tableBits = 10;
+
+    double eta;
+    // Half the signed spread factor: the first 2^tableBits entries for the child
+    // nearer to a, the rest for the one nearer to b
+    std::vector<double> halfSpreads;
+};
+
+#endif // CROSSOVER_H
@@ -1,7 +1,10 @@
 #ifndef INDIVIDUAL_H
 #define INDIVIDUAL_H
 
+#include <cstddef>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 class Individual
 {
@@ -13,13 +16,56 @@ public:
 
     virtual void evaluate() = 0;
 
+    // Evaluates batch[0..n), fitnesses already reset, which includes this individual
+    // as batch[0]. Implementations may run them together, e.g. several networks in
+    // one SIMD pass, and must fall back on evaluate() for types they do not handle.
+    virtual void evaluateBatch(Individual* const* batch, size_t n)
+    {
+        for(size_t i = 0; i < n; ++i) {
+            batch[i]->evaluate();
+        }
+    }
+
     virtual void mutate() = 0;
     virtual void mutateFrom(const Individual*) = 0;
 
+    // Two-parent reproduction: overwrite this genome with a recombination of a's and
+    // b's, written straight from their buffers, then mutate. Returns false if not
+    // supported, e.g. for mismatched types, and the caller falls back on mutateFrom(a).
+    virtual bool crossoverFrom(const Individual*, const Individual*) { return false; }
+
+    // Local search written back into the genome (Lamarckian), e.g. a few gradient
+    // steps. Must not make the individual worse on the current samples.
+    virtual void refine() {}
+
     virtual void dump(std::ostream& os) const {}
 
+    // Deep copy, allocated by the calling thread. Lets a population move individuals
+    // onto the NUMA node that evaluates them; nullptr if not supported.
+    virtual std::unique_ptr<Individual> clone() const { return nullptr; }
+
+    // Behavior descriptor for novelty search, e.g. the outputs on fixed probe inputs,
+    // recorded by evaluate(). Individuals without one return nullptr.
+    virtual const std::vector<double>* getBehavior() const { return nullptr; }
+
+    // Objective values for multi-objective ranking, all minimized, recorded by
+    // evaluate(). Individuals without them are ranked on their fitness alone.
+    virtual const std::vector<double>* getObjectives() const { return nullptr; }
+
+    // Appends cheap descriptors of the last mutation for surrogate models, e.g.
+    // its step size. Must add the same number of values for every individual.
+    virtual void getFeatures(std::vector<double>&) const {}
+
+    double getNovelty() const { return novelty; }
+    void setNovelty(double n) { novelty = n; }
+
+    // Real-valued parameters, for strategies that search the genome directly.
+    // Individuals without such a representation return nullptr.
+    virtual std::vector<double>* getGenome() { return nullptr; }
+
 protected:
     double fitness{ 0 };
+    double novelty{ 0 };
 };
 
 #endif
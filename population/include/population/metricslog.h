@@ -0,0 +1,92 @@
+#ifndef METRICSLOG_H
+#define METRICSLOG_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Distribution of a value over the population
+struct Summary
+{
+    double min{ 0 };
+    double median{ 0 };
+    double max{ 0 };
+    double mean{ 0 };
+};
+
+// Reorders values. All zero if values is empty.
+Summary summarize(std::vector<double>& values);
+
+// Statistics of one generation, stored as is in a metrics log
+struct GenerationMetrics
+{
+    uint64_t generation{ 0 };
+    uint64_t evaluations{ 0 };
+    // Improvements of the best so far since the start
+    uint64_t improvements{ 0 };
+    double elapsedSeconds{ 0 };
+    double generationSeconds{ 0 };
+    // Of the individuals with a finite fitness, i.e. those evaluated
+    Summary fitness;
+    // Self-adapted mutation stddevs
+    Summary stddev;
+};
+
+// Appendable log of GenerationMetrics. log() only queues a record; a background
+// thread writes them in batches, so that logging every generation costs the
+// loop next to nothing.
+//
+// File layout (native byte order): the magic "EVNNML01" and the uint64 record
+// size, then fixed-size records, oldest first.
+class MetricsLog
+{
+public:
+    // Unless append is false, records go after those of an existing log. A record
+    // cut off by a crash is dropped first. Throws if the file cannot be opened or
+    // is not a metrics log.
+    explicit MetricsLog(const std::string& path, bool append = true);
+    ~MetricsLog();
+
+    MetricsLog(const MetricsLog&) = delete;
+    MetricsLog& operator=(const MetricsLog&) = delete;
+
+    // Ignored once closed
+    void log(const GenerationMetrics& metrics);
+
+    // Waits until everything logged so far is written. Throws after a write error.
+    void flush();
+    // Flushes and stops the writer. Throws after a write error.
+    void close();
+
+private:
+    void stopWriter();
+    void writerLoop();
+
+    std::string path;
+    std::ofstream os;
+    std::thread writer;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    std::vector<GenerationMetrics> pending;
+    uint64_t numLogged{ 0 };
+    uint64_t numWritten{ 0 };
+    bool flushing{ false };
+    bool stopping{ false };
+    bool failed{ false };
+};
+
+// All complete records of a log. Throws if it cannot be read or is not a metrics log.
+std::vector<GenerationMetrics> readMetricsLog(const std::string& path);
+
+// One row per generation, with a header row
+void writeMetricsCsv(std::ostream& os, const std::vector<GenerationMetrics>& metrics);
+
+#endif // METRICSLOG_H
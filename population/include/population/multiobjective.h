@@ -0,0 +1,39 @@
+#ifndef MULTIOBJECTIVE_H
+#define MULTIOBJECTIVE_H
+
+#include "population/population.h"
+
+#include <cstddef>
+#include <vector>
+
+// All objectives are minimized. a dominates b if it is no worse in every
+// objective and better in at least one.
+bool dominates(const double* a, const double* b, size_t m);
+
+// Pareto front of each of the n points (rows of m objectives), 0 being the
+// non-dominated set. All cases sweep the points in lexicographic order and binary
+// search the front of each one. Two objectives compare against each front's last
+// point, O(N log N); three against a staircase per front, O(N log^2 N); more use
+// ENS-BS with explicit dominance checks against the front members.
+std::vector<size_t> nonDominatedSort(const double* objectives, size_t n, size_t m);
+
+// Crowding distance of each point of one front, given by indices into objectives.
+// Boundary points of every objective get infinity.
+std::vector<double> crowdingDistances(const double* objectives, size_t m, const std::vector<size_t>& front);
+
+// NSGA-II ranking: by front, then by descending crowding distance within a front.
+// Objectives come from Individual::getObjectives, or the fitness alone without.
+class Nsga2 : public Ranking
+{
+public:
+    void rank(PopulationVector& individuals, NodeThreadPool* pool = nullptr) override;
+
+    // Fronts of the last ranking, by position after sorting
+    const std::vector<size_t>& getFronts() const { return sortedFronts; }
+
+private:
+    std::vector<double> objectives;
+    std::vector<size_t> sortedFronts;
+};
+
+#endif // MULTIOBJECTIVE_H
@@ -0,0 +1,52 @@
+#ifndef MUTATION_H
+#define MUTATION_H
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// One changed genome entry: genome[index] was increased by change.
+struct GenomeDelta
+{
+    size_t index;
+    double change;
+};
+
+// Picks each index of [0, n) independently with probability p, in ascending
+// order. Gaps between picks are drawn from the geometric distribution, so the
+// cost is proportional to the number of indices picked rather than to n.
+// For p > 0 at least one index is picked: an empty draw, which would make an
+// unchanged clone that still costs an evaluation, becomes one uniform pick.
+template<typename Engine>
+void sampleSparseIndices(size_t n, double p, Engine& engine, std::vector<size_t>& indices)
+{
+    indices.clear();
+    if(p <= 0 || n == 0) {
+        return;
+    }
+    if(p >= 1) {
+        for(size_t i = 0; i < n; ++i) {
+            indices.push_back(i);
+        }
+        return;
+    }
+
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const auto logQ = std::log1p(-p);
+    double pos = -1;
+    for(;;) {
+        // 1 - u lies in (0, 1], keeping the logarithm finite
+        const auto skip = std::floor(std::log(1 - uniform(engine)) / logQ);
+        pos += 1 + skip;
+        if(pos >= static_cast<double>(n)) {
+            break;
+        }
+        indices.push_back(static_cast<size_t>(pos));
+    }
+    if(indices.empty()) {
+        indices.push_back(std::uniform_int_distribution<size_t>(0, n - 1)(engine));
+    }
+}
+
+#endif // MUTATION_H
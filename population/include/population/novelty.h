@@ -0,0 +1,99 @@
+#ifndef NOVELTY_H
+#define NOVELTY_H
+
+#include "population/numa.h"
+#include "population/population.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Euclidean distance squared between a[0..n) and b[0..n)
+double squaredDistance(const double* a, const double* b, size_t n);
+
+struct Neighbor
+{
+    double distance;
+    size_t index;
+
+    bool operator<(const Neighbor& other) const { return distance < other.distance; }
+};
+
+// Max-heap (std::push_heap order) of the k nearest neighbors found so far
+void offerNeighbor(std::vector<Neighbor>& heap, size_t k, const Neighbor& candidate);
+
+// Vantage-point tree for exact k-nearest-neighbor queries in Euclidean space.
+// Points are copied in tree order, so each subtree is one contiguous block.
+class VpTree
+{
+public:
+    VpTree() : dim{0} {}
+
+    // points holds n rows of dim values; neighbors report the row index
+    void build(const double* points, size_t n, size_t dim);
+
+    size_t size() const { return ids.size(); }
+
+    // Merges the k nearest points, other than the one with index exclude, into heap
+    void search(const double* query, size_t k, std::vector<Neighbor>& heap, size_t exclude = SIZE_MAX) const;
+
+private:
+    static const size_t leafSize = 8;
+
+    void buildRange(size_t begin, size_t end, std::vector<size_t>& order, const double* points);
+    void searchRange(size_t begin, size_t end, const double* query, size_t k,
+                     std::vector<Neighbor>& heap, size_t exclude) const;
+
+    size_t dim;
+    std::vector<double> coords;
+    std::vector<size_t> ids;
+    // For the vantage point at the start of each inner node: median distance, and
+    // where the outside subtree starts. The inside subtree directly follows the node.
+    std::vector<double> thresholds;
+    std::vector<size_t> splits;
+};
+
+// Behaviors kept across generations. New entries go to a linear pending list,
+// and the tree is rebuilt once that grows past a quarter of the indexed entries,
+// which keeps insertion amortized O(log n) and queries close to tree speed.
+class NoveltyArchive
+{
+public:
+    void add(const double* behavior, size_t dim);
+    size_t size() const { return points.size() / (dim ? dim : 1); }
+
+    void search(const double* query, size_t k, std::vector<Neighbor>& heap) const;
+
+private:
+    size_t dim{ 0 };
+    std::vector<double> points;
+    size_t indexed{ 0 };
+    VpTree tree;
+};
+
+// Ranks individuals by how different their behavior (Individual::getBehavior) is
+// from the rest of the population and from an archive of past behaviors: the mean
+// distance to the k nearest. weight blends the novelty rank with the fitness rank,
+// 1 is pure novelty search.
+class NoveltySearch : public Ranking
+{
+public:
+    explicit NoveltySearch(size_t k = 15, size_t archivePerGeneration = 2, double weight = 1.0);
+
+    // Sets the novelty of every individual, archives the most novel ones and sorts
+    // by the blended rank. Queries are spread over the pool's workers if given.
+    void rank(PopulationVector& individuals, NodeThreadPool* pool = nullptr) override;
+
+    const NoveltyArchive& getArchive() const { return archive; }
+
+private:
+    size_t k;
+    size_t archivePerGeneration;
+    double weight;
+
+    NoveltyArchive archive;
+    VpTree populationTree;
+    std::vector<double> behaviors;
+};
+
+#endif // NOVELTY_H
@@ -0,0 +1,64 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct NumaNode
+{
+    size_t id;
+    std::vector<int> cpus;
+};
+
+// Nodes listed in /sys/devices/system/node. Where that is unavailable, a single
+// node holding every CPU.
+std::vector<NumaNode> getNumaNodes();
+
+// Parses a kernel CPU list such as "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& list);
+
+// Restricts the calling thread to the given CPUs. Returns false where unsupported.
+bool pinCurrentThread(const std::vector<int>& cpus);
+
+// Worker threads pinned to the CPUs of their NUMA node. Memory a worker allocates
+// and touches first is placed on its node by the kernel's first-touch policy.
+class NodeThreadPool
+{
+public:
+    // Task arguments: node index, worker index within the node, workers of the node
+    using Task = std::function<void(size_t node, size_t worker, size_t nWorkers)>;
+
+    // threadsPerNode = 0 starts one worker per CPU of the node
+    explicit NodeThreadPool(const std::vector<NumaNode>& nodes, size_t threadsPerNode = 0);
+    ~NodeThreadPool();
+
+    NodeThreadPool(NodeThreadPool const&) = delete;
+    NodeThreadPool& operator=(NodeThreadPool const&) = delete;
+
+    size_t getNumNodes() const { return workersPerNode.size(); }
+    size_t getNumWorkers(size_t node) const { return workersPerNode[node]; }
+
+    // Runs task once on every worker and returns when all have finished
+    void run(const Task& task);
+
+private:
+    void workerLoop(size_t node, size_t worker, std::vector<int> cpus);
+
+    std::vector<size_t> workersPerNode;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const Task* task{ nullptr };
+    size_t round{ 0 };
+    size_t pending{ 0 };
+    bool stopping{ false };
+};
+
+#endif // NUMA_H
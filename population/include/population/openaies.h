@@ -0,0 +1,74 @@
+#ifndef OPENAIES_H
+#define OPENAIES_H
+
+#include "population/population.h"
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Block of standard normal noise shared by everyone who knows the seed it was
+// generated from. A perturbation is then fully described by an offset into it.
+class NoiseTable
+{
+public:
+    explicit NoiseTable(size_t size = size_t(1) << 24, unsigned int seed = 0);
+
+    const float* get(size_t offset) const { return &noise[offset]; }
+    size_t size() const { return noise.size(); }
+
+    template<typename Engine>
+    size_t sampleOffset(Engine& engine, size_t dim) const
+    {
+        std::uniform_int_distribution<size_t> dis(0, noise.size() - dim);
+        return dis(engine);
+    }
+
+private:
+    std::vector<float> noise;
+};
+
+// Evolution strategies as in Salimans et al., "Evolution Strategies as a
+// Scalable Alternative to Reinforcement Learning". One central parameter vector
+// is perturbed by antithetic pairs +-sigma*eps read from a NoiseTable; the
+// gradient estimate uses centered fitness ranks and is applied with Adam.
+// A candidate is identified by (noise offset, sign) alone, so remote workers
+// only need to exchange offsets and fitnesses.
+class OpenAiEs : public Strategy
+{
+public:
+    OpenAiEs(const std::vector<double>& initialCenter, double sigma, double learningRate,
+             std::shared_ptr<const NoiseTable> table, unsigned int seed = 0);
+
+    void sample(PopulationVector& individuals) override;
+    void update(const PopulationVector& individuals) override;
+
+    // Writes center + sign * sigma * eps(offset) to out
+    void perturb(size_t offset, double sign, double* out) const;
+
+    const std::vector<double>& getCenter() const { return center; }
+
+private:
+    struct Candidate
+    {
+        size_t offset;
+        double sign;
+    };
+
+    std::vector<double> center;
+    double sigma;
+    double learningRate;
+    std::shared_ptr<const NoiseTable> table;
+    std::default_random_engine engine;
+
+    std::unordered_map<const Individual*, Candidate> candidates;
+    std::vector<double> gradient;
+
+    // Adam state
+    std::vector<double> m;
+    std::vector<double> v;
+    size_t step{ 0 };
+};
+
+#endif // OPENAIES_H
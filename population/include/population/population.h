@@ -2,13 +2,51 @@
 #define POPULATION_H
 
 #include "population/individual.h"
+#include "population/numa.h"
+#include "population/runcontrol.h"
+#include "population/surrogate.h"
+#include "population/taskpool.h"
 
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <unordered_map>
 
 
 using PopulationVector = std::vector<std::unique_ptr<Individual>>;
 
+// Called before evaluation with fullSet = false to pick the generation's samples,
+// and with fullSet = true before elites are re-scored on all samples.
+using SampleSelector = std::function<void(bool fullSet)>;
+
+// Replaces the built-in truncation selection and mutation of Population::evolve.
+class Strategy
+{
+public:
+    virtual ~Strategy() {}
+
+    // Overwrite the individuals with the candidates of the next generation.
+    virtual void sample(PopulationVector& individuals) = 0;
+
+    // Learn from the evaluated candidates, sorted best (lowest fitness) first.
+    virtual void update(const PopulationVector& individuals) = 0;
+};
+
+// Replaces sorting by fitness in Population::evolve, e.g. ranking by novelty or
+// by Pareto front. Truncation selection then keeps the top ranked half.
+class Ranking
+{
+public:
+    virtual ~Ranking() {}
+
+    // Sort the evaluated individuals best first. Individuals with a non-finite
+    // fitness are not passed in; they always rank last. Work may be spread over
+    // pool, if given.
+    virtual void rank(PopulationVector& individuals, NodeThreadPool* pool) = 0;
+};
+
 class Population
 {
 public:
@@ -22,11 +60,105 @@ public:
     Individual* getIndividual(size_t i) const;
     void addIndividual(std::unique_ptr<Individual>&& idv);
 
+    void setSampleSelector(SampleSelector selector, size_t rescoreInterval = 1, size_t numElites = 1);
+    void setStrategy(std::unique_ptr<Strategy>&& s);
+    // Elites improved by Individual::refine() each generation; ignored under a Strategy
+    void setNumRefined(size_t n) { numRefined = n; }
+
+    // Under truncation selection, each offspring is made by Individual::crossoverFrom
+    // with probability rate, from its own parent and a mate drawn from the other parents
+    void setCrossoverRate(double rate, unsigned int seed = 0);
+
+    // Individuals are handed to Individual::evaluateBatch in chunks of this size
+    void setBatchSize(size_t n) { batchSize = n; }
+
+    // Evaluates on worker threads pinned to the given NUMA nodes, which requires a
+    // thread-safe evaluateBatch. Individuals are split into one partition per node.
+    // With firstTouch, each is cloned once by a worker of its node so its memory
+    // lives there. Reproduction keeps individuals in place, so only the genome an
+    // offspring copies from a parent in another partition crosses nodes.
+    void setNumaNodes(const std::vector<NumaNode>& nodes, size_t threadsPerNode = 0, bool firstTouch = true);
+
+    // Evaluates chunks of batch size as tasks of a pool shared with other callers,
+    // which requires a thread-safe evaluateBatch. The pool must outlive the population.
+    // NUMA nodes take precedence.
+    void setTaskPool(TaskPool* p) { taskPool = p; }
+
+    // Orders individuals by r instead of fitness alone. getIndividual(0) is then
+    // the top ranked, not necessarily the fittest.
+    void setRanking(std::unique_ptr<Ranking>&& r);
+
+    // Pre-screens mutated individuals under truncation selection: the surrogate
+    // predicts their fitness from their parent's fitness and Individual::getFeatures,
+    // and only the most promising fraction is evaluated. The rest get an infinite
+    // fitness and are replaced by the next offspring. Below a fraction of one half,
+    // some of them survive as parents, and their offspring are always evaluated.
+    // A ranking only sees the evaluated individuals.
+    void setSurrogate(std::unique_ptr<Surrogate>&& s);
+    const Surrogate* getSurrogate() const { return surrogate.get(); }
+
     void evolve();
 
+    // Evolves until control says to stop and returns why. After every generation
+    // the fittest individual is offered to best, if given, for other threads to read.
+    StopReason run(RunControl& control, BestSoFar* best = nullptr);
+
+    // While set, evaluation stops early once control->shouldAbort(). The generation
+    // under way then ends after the chunks in progress; its unevaluated individuals
+    // get an infinite fitness, and refinement, re-scoring and strategy updates are
+    // skipped.
+    void setRunControl(const RunControl* c) { runControl = c; }
+
+    // Individual evaluations so far, refinement, re-scoring and abandoned ones included
+    size_t getEvaluations() const { return evaluations; }
+
 private:
+    // Resets and evaluates individuals [first, last)
+    void evaluateRange(size_t first, size_t last);
+    void evaluateIndices(const std::vector<size_t>& indices);
+    void evaluateOnNodes(const std::vector<size_t>& indices);
+    void evaluateScreened(const std::vector<double>& priorFitness);
+    void rankEvaluated();
+
+    // Splits the individuals into contiguous per-node partitions, first-touching them if enabled
+    void assignNodes();
+
     std::unique_ptr<PopulationVector> individuals;
     bool isFirstGeneration{ true };
+    size_t generation{ 0 };
+
+    SampleSelector sampleSelector;
+    size_t rescoreInterval{ 0 };
+    size_t numElites{ 0 };
+
+    std::unique_ptr<Strategy> strategy;
+    size_t numRefined{ 0 };
+
+    double crossoverRate{ 0 };
+    std::default_random_engine crossoverEngine;
+
+    size_t batchSize{ 64 };
+    std::vector<Individual*> batch;
+
+    size_t evaluations{ 0 };
+    TaskPool* taskPool{ nullptr };
+
+    const RunControl* runControl{ nullptr };
+    std::atomic<bool> aborted{ false };
+    // Checks for abort before evaluating a chunk; true if it was skipped
+    bool skipIfAborting(Individual* const* chunk, size_t n);
+
+    std::unique_ptr<NodeThreadPool> pool;
+    bool firstTouch{ false };
+    std::unordered_map<const Individual*, size_t> homeNode;
+    std::vector<std::vector<Individual*>> nodeMembers;
+
+    std::unique_ptr<Ranking> ranking;
+
+    std::unique_ptr<Surrogate> surrogate;
+    // Fitness of each individual's genome before this generation's mutation
+    std::vector<double> priorFitness;
+    std::vector<std::vector<double>> features;
 };
 
 #endif
@@ -0,0 +1,95 @@
+#ifndef RUNCONTROL_H
+#define RUNCONTROL_H
+
+#include "population/individual.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+// When an evolution run ends; it stops at the first criterion met. Zero counts mean no limit.
+struct StopCriteria
+{
+    size_t maxGenerations{ 0 };
+    size_t maxEvaluations{ 0 };
+    double maxSeconds{ std::numeric_limits<double>::infinity() };
+    double targetFitness{ -std::numeric_limits<double>::infinity() };
+
+    // Stop after this many generations without the best fitness improving on the
+    // best before by more than minImprovement, relative to its magnitude
+    size_t stagnationGenerations{ 0 };
+    double minImprovement{ 0 };
+};
+
+enum class StopReason { None, Generations, Evaluations, Deadline, Target, Stagnation, Cancelled };
+
+const char* toString(StopReason reason);
+
+// Checks the stop criteria of a run generation by generation. Cancellation and
+// the deadline can also be polled inside a generation, from any thread, to
+// abandon it early.
+class RunControl
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RunControl(const StopCriteria& criteria = StopCriteria{});
+
+    // Restarts the clock and the counts. A cancellation stays.
+    void start();
+
+    // Records a finished or abandoned generation; true once the run should stop
+    bool update(double bestFitness, size_t evaluations);
+
+    // Thread-safe
+    void cancel() { cancelled = true; }
+    bool isCancelled() const { return cancelled; }
+
+    // Thread-safe: whether a generation under way should be abandoned
+    bool shouldAbort() const { return cancelled || Clock::now() >= deadline; }
+
+    StopReason getStopReason() const { return reason; }
+    size_t getGenerations() const { return generations; }
+    double getBestFitness() const { return bestFitness; }
+    double getElapsedSeconds() const;
+
+    const StopCriteria& getCriteria() const { return criteria; }
+
+private:
+    StopCriteria criteria;
+    Clock::time_point startTime;
+    Clock::time_point deadline;
+    std::atomic<bool> cancelled{ false };
+
+    StopReason reason{ StopReason::None };
+    size_t generations{ 0 };
+    double bestFitness{ std::numeric_limits<double>::infinity() };
+    // Best fitness when an improvement last counted for the stagnation window
+    double referenceFitness{ std::numeric_limits<double>::infinity() };
+    size_t lastImprovement{ 0 };
+};
+
+// The fittest individual offered so far, as a copy that other threads can read
+// at any time while the run goes on
+class BestSoFar
+{
+public:
+    // Keeps a clone of idv if it is fitter than the current best. Returns whether it was.
+    bool offer(const Individual& idv);
+
+    // nullptr until an individual that supports clone() was offered
+    std::shared_ptr<const Individual> get() const;
+    double getFitness() const;
+
+    void reset();
+
+private:
+    mutable std::mutex mutex;
+    std::shared_ptr<const Individual> best;
+    double fitness{ std::numeric_limits<double>::infinity() };
+};
+
+#endif // RUNCONTROL_H
@@ -0,0 +1,82 @@
+#ifndef SEEDGENOME_H
+#define SEEDGENOME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Gaussian perturbation of every genome entry, fully determined by its seed.
+struct SeedMutation
+{
+    uint64_t seed;
+    double stddev;
+};
+
+// Least recently used store of materialized genomes, keyed by SeedGenome::getId().
+// Thread-safe: entries are copied in and out under a lock, so concurrent
+// evaluations may share one cache.
+class GenomeCache
+{
+public:
+    explicit GenomeCache(size_t capacity) : capacity{ capacity } {}
+
+    // Copies the genome into out if cached
+    bool find(uint64_t id, std::vector<double>& out);
+    void insert(uint64_t id, const std::vector<double>& genome);
+
+    size_t size() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+
+private:
+    using Entry = std::pair<uint64_t, std::vector<double>>;
+
+    mutable std::mutex mutex;
+    size_t capacity;
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    size_t hits{ 0 };
+    size_t misses{ 0 };
+};
+
+// A genome stored as its lineage: a base vector followed by the chain of seeded
+// mutations applied to it. Copies and offspring share the chain, so each
+// generation adds only one small node per individual. Reconstruction replays
+// the chain from the nearest cached ancestor. Once a chain reaches maxDepth, the
+// ancestor halfway up becomes the new base, which bounds that cost. All genomes
+// descending from that ancestor share the one base it becomes, so under
+// selection the live bases stay few.
+class SeedGenome
+{
+public:
+    SeedGenome() {}
+    explicit SeedGenome(std::vector<double> base, size_t maxDepth = 64);
+    // All-zero base of n entries, which takes no storage
+    explicit SeedGenome(size_t n, size_t maxDepth = 64);
+
+    void mutate(const SeedMutation& mutation, GenomeCache* cache = nullptr);
+    void materialize(std::vector<double>& out, GenomeCache* cache = nullptr) const;
+
+    uint64_t getId() const;
+    size_t getDepth() const;
+    size_t size() const;
+    // The stored base values, nullptr for an all-zero base
+    const std::vector<double>* getBase() const;
+
+    static void applyMutation(const SeedMutation& mutation, double* genome, size_t n);
+
+private:
+    struct Node;
+
+    void rebase(GenomeCache* cache);
+    static void materialize(const Node* node, std::vector<double>& out, GenomeCache* cache);
+
+    std::shared_ptr<const Node> node;
+    size_t maxDepth{ 64 };
+};
+
+#endif // SEEDGENOME_H
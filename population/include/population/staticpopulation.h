@@ -0,0 +1,208 @@
+#ifndef STATICPOPULATION_H
+#define STATICPOPULATION_H
+
+#include "population/population.h"
+#include "tracing/trace.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// True if T has static void evaluateBatch(T* const* batch, size_t n)
+template<typename T, typename = void>
+struct HasBatchEvaluation : std::false_type {};
+
+template<typename T>
+struct HasBatchEvaluation<T, std::void_t<decltype(T::evaluateBatch(std::declval<T* const*>(), size_t{}))>>
+    : std::true_type {};
+
+// True if T has bool crossoverFrom(const T& a, const T& b)
+template<typename T, typename = void>
+struct HasCrossover : std::false_type {};
+
+template<typename T>
+struct HasCrossover<T, std::void_t<decltype(bool{ std::declval<T&>().crossoverFrom(std::declval<const T&>(),
+                                                                                   std::declval<const T&>()) })>>
+    : std::true_type {};
+
+// Population of a single individual type held by value in one contiguous vector.
+// Calls go straight to T, so with a final class there is no virtual dispatch and
+// no dynamic_cast in the loop. T needs evaluate(), mutate(), mutateFrom(const T&),
+// refine(), getFitness() and setFitness(), and may add a static evaluateBatch(T* const*, size_t)
+// to evaluate chunks of individuals together and crossoverFrom(const T&, const T&) for
+// two-parent reproduction. Evolves like Population with truncation
+// selection; use Population for strategies or mixed individual types.
+template<typename T>
+class StaticPopulation
+{
+public:
+    size_t size() const { return individuals.size(); }
+
+    // Individuals ranked best first after evolve()
+    T& getIndividual(size_t i) { return individuals[ranking[i]]; }
+    const T& getIndividual(size_t i) const { return individuals[ranking[i]]; }
+
+    void addIndividual(T&& idv)
+    {
+        ranking.push_back(individuals.size());
+        individuals.emplace_back(std::move(idv));
+    }
+
+    void setSampleSelector(SampleSelector selector, size_t rescoreInterval_ = 1, size_t numElites_ = 1)
+    {
+        sampleSelector = std::move(selector);
+        rescoreInterval = rescoreInterval_;
+        numElites = numElites_;
+    }
+
+    void setNumRefined(size_t n) { numRefined = n; }
+    void setBatchSize(size_t n) { batchSize = n; }
+
+    // Same as Population::setCrossoverRate; needs T::crossoverFrom
+    void setCrossoverRate(double rate, unsigned int seed = 0)
+    {
+        static_assert(HasCrossover<T>::value, "T has no crossoverFrom(const T&, const T&)");
+        crossoverRate = rate;
+        crossoverEngine.seed(seed);
+    }
+
+    void evolve();
+
+    // Same as in Population
+    size_t getEvaluations() const { return evaluations; }
+    void setRunControl(const RunControl* c) { runControl = c; }
+
+private:
+    // Resets and evaluates the individuals ranked [first, last)
+    void evaluateRange(size_t first, size_t last)
+    {
+        TRACE_SCOPE("evaluate");
+        for(size_t i = first; i < last; ++i) {
+            getIndividual(i).setFitness(0);
+        }
+        evaluations += last - first;
+        const auto chunk = HasBatchEvaluation<T>::value ? std::max<size_t>(1, batchSize) : 1;
+        for(size_t begin = first; begin < last; begin += chunk) {
+            const auto end = std::min(last, begin + chunk);
+            if(aborted || (runControl && runControl->shouldAbort())) {
+                aborted = true;
+                for(size_t i = begin; i < last; ++i) {
+                    getIndividual(i).setFitness(std::numeric_limits<double>::infinity());
+                }
+                return;
+            }
+            TRACE_SCOPE("evaluateBatch");
+            if constexpr(HasBatchEvaluation<T>::value) {
+                batch.clear();
+                for(size_t i = begin; i < end; ++i) {
+                    batch.push_back(&getIndividual(i));
+                }
+                T::evaluateBatch(batch.data(), batch.size());
+            }
+            else {
+                getIndividual(begin).evaluate();
+            }
+        }
+    }
+
+    void sortRanks(size_t n)
+    {
+        std::stable_sort(ranking.begin(), ranking.begin() + n, [this](size_t a, size_t b) {
+            return individuals[a].getFitness() < individuals[b].getFitness();
+        });
+    }
+
+    std::vector<T> individuals;
+    // Individuals stay in place; sorting only permutes these indices
+    std::vector<size_t> ranking;
+    bool isFirstGeneration{ true };
+    size_t generation{ 0 };
+
+    SampleSelector sampleSelector;
+    size_t rescoreInterval{ 0 };
+    size_t numElites{ 0 };
+
+    size_t numRefined{ 0 };
+
+    double crossoverRate{ 0 };
+    std::default_random_engine crossoverEngine;
+
+    size_t batchSize{ 64 };
+    std::vector<T*> batch;
+
+    size_t evaluations{ 0 };
+    const RunControl* runControl{ nullptr };
+    bool aborted{ false };
+};
+
+template<typename T>
+void StaticPopulation<T>::evolve()
+{
+    TRACE_SCOPE("evolve");
+    aborted = false;
+    if(!isFirstGeneration) {
+        TRACE_SCOPE("reproduce");
+        const auto halfSize = individuals.size() / 2;
+        std::uniform_real_distribution<double> chance(0, 1);
+        std::uniform_int_distribution<size_t> pickMate(0, halfSize > 1 ? halfSize - 2 : 0);
+        for(size_t i = 0; i < halfSize; ++i) {
+            auto& parent = getIndividual(i);
+            auto& offspring = getIndividual(halfSize + i);
+            bool crossed = false;
+            if constexpr(HasCrossover<T>::value) {
+                if(halfSize > 1 && crossoverRate > 0 && chance(crossoverEngine) < crossoverRate) {
+                    auto mate = pickMate(crossoverEngine);
+                    mate += mate >= i;
+                    crossed = offspring.crossoverFrom(parent, getIndividual(mate));
+                }
+            }
+            if(!crossed) {
+                offspring.mutateFrom(parent);
+            }
+        }
+        for(size_t i = 1; i < halfSize; ++i) {
+            getIndividual(i).mutate();
+        }
+    }
+
+    if(sampleSelector) {
+        sampleSelector(false);
+    }
+
+    evaluateRange(0, individuals.size());
+    {
+        TRACE_SCOPE("rank");
+        sortRanks(individuals.size());
+    }
+    if(aborted) {
+        isFirstGeneration = false;
+        ++generation;
+        return;
+    }
+
+    const auto nRefine = std::min(numRefined, individuals.size());
+    if(nRefine) {
+        TRACE_SCOPE("refine");
+        for(size_t i = 0; i < nRefine; ++i) {
+            getIndividual(i).refine();
+        }
+        evaluateRange(0, nRefine);
+        sortRanks(nRefine);
+    }
+
+    if(sampleSelector && rescoreInterval != 0 && generation % rescoreInterval == 0) {
+        TRACE_SCOPE("rescore");
+        sampleSelector(true);
+        const auto nRescore = std::min(numElites, individuals.size());
+        evaluateRange(0, nRescore);
+        sortRanks(nRescore);
+    }
+
+    isFirstGeneration = false;
+    ++generation;
+}
+
+#endif // STATICPOPULATION_H
@@ -0,0 +1,76 @@
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <cstddef>
+#include <vector>
+
+// Least squares fit of a linear model, trained online. The ridge penalty is
+// relative to each feature's own scale, and forgetting down-weights the samples
+// of earlier generations as the population moves on.
+class RidgeRegression
+{
+public:
+    explicit RidgeRegression(double lambda = 1e-3, double forgetting = 0.9);
+
+    void add(const std::vector<double>& x, double y);
+
+    // Decays the statistics gathered so far and refits the coefficients
+    void endGeneration();
+
+    double predict(const std::vector<double>& x) const;
+
+    size_t getSamples() const { return samples; }
+    const std::vector<double>& getCoefficients() const { return coefficients; }
+
+private:
+    double lambda;
+    double forgetting;
+    size_t samples{ 0 };
+    std::vector<double> xtx;
+    std::vector<double> xty;
+    std::vector<double> coefficients;
+};
+
+struct SurrogateReport
+{
+    size_t generations{ 0 };     // generations that were screened
+    size_t candidates{ 0 };      // offspring and mutated parents of those generations
+    size_t evaluated{ 0 };       // of those, evaluated for real
+    double rankCorrelation{ 0 }; // mean Spearman correlation of prediction and fitness
+
+    double getSavings() const { return candidates ? 1 - static_cast<double>(evaluated) / candidates : 0; }
+};
+
+// Predicts the fitness of mutated individuals from their features, see
+// Population::setSurrogate, so that only the most promising get evaluated.
+class Surrogate
+{
+public:
+    // evaluateFraction of the candidates get a real evaluation once the model
+    // has seen warmupSamples evaluations; before that, all of them do.
+    explicit Surrogate(double evaluateFraction = 0.5, size_t warmupSamples = 200);
+
+    bool isReady() const { return model.getSamples() >= warmupSamples; }
+    double getEvaluateFraction() const { return evaluateFraction; }
+
+    double predict(const std::vector<double>& features) const { return model.predict(features); }
+    void learn(const std::vector<double>& features, double fitness) { model.add(features, fitness); }
+
+    // Closes a generation. predicted and actual are for the evaluated candidates
+    // of a screened generation, and empty otherwise.
+    void endGeneration(size_t nCandidates, size_t nEvaluated,
+                       const std::vector<double>& predicted, const std::vector<double>& actual);
+
+    const SurrogateReport& getReport() const { return report; }
+
+private:
+    double evaluateFraction;
+    size_t warmupSamples;
+    RidgeRegression model;
+    SurrogateReport report;
+};
+
+// Spearman rank correlation of a and b, ties broken by position
+double rankCorrelation(const std::vector<double>& a, const std::vector<double>& b);
+
+#endif // SURROGATE_H
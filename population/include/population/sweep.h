@@ -0,0 +1,97 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "population/population.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Hyperparameter values of one run of a sweep
+struct SweepPoint
+{
+    std::vector<std::string> names;
+    std::vector<double> values;
+    unsigned int seed{ 0 };
+
+    // Value of the named parameter, fallback if the sweep does not set it
+    double get(const std::string& name, double fallback = 0) const;
+};
+
+// Parameters of a sweep, each a list of values or a continuous range
+class SweepSpec
+{
+public:
+    SweepSpec& addValues(const std::string& name, std::vector<double> values);
+
+    // Uniform in [low, high], or log-uniform with logScale
+    SweepSpec& addRange(const std::string& name, double low, double high, bool logScale = false);
+
+    // Every combination of the parameters' values, ranges taking gridSteps evenly
+    // spaced ones (on a log scale if so set), each repeated with seedsPerPoint seeds
+    std::vector<SweepPoint> getGrid(size_t gridSteps = 3, size_t seedsPerPoint = 1, unsigned int seed = 0) const;
+
+    // Random search: n points with each parameter drawn independently
+    std::vector<SweepPoint> getRandom(size_t n, unsigned int seed = 0) const;
+
+private:
+    struct Parameter
+    {
+        std::string name;
+        std::vector<double> values; // empty for a range
+        double low;
+        double high;
+        bool logScale;
+    };
+
+    std::vector<Parameter> parameters;
+};
+
+struct SweepResult
+{
+    SweepPoint point;
+    double finalFitness{ 0 };
+    // Seconds until the best fitness first reached the target, infinity if it never did
+    double timeToTarget{ 0 };
+    size_t evaluations{ 0 };
+    double seconds{ 0 };
+
+    double getEvaluationsPerSecond() const { return seconds > 0 ? evaluations / seconds : 0; }
+};
+
+// Sets up the run of a point, on the thread that then evolves it. Whatever the
+// individuals refer to, e.g. their samples, must live as long as the population,
+// for instance held by its sample selector.
+using TrialFactory = std::function<std::unique_ptr<Population>(const SweepPoint&)>;
+
+// Evolves many independent populations at once. Each run has a driver thread for
+// its generation loop, and all runs hand their evaluation chunks to one TaskPool,
+// so drivers waiting on evaluations, or out of runs, work on other runs' chunks.
+class SweepRunner
+{
+public:
+    // nThreads = 0 takes one per CPU. Up to concurrentRuns of them (0: all) drive
+    // runs, the rest are pool workers. Needs a thread-safe evaluateBatch.
+    explicit SweepRunner(size_t nThreads = 0, size_t concurrentRuns = 0);
+
+    void setGenerations(size_t n) { generations = n; }
+    void setTargetFitness(double f) { targetFitness = f; }
+
+    // Results in the order of points
+    std::vector<SweepResult> run(const std::vector<SweepPoint>& points, const TrialFactory& factory) const;
+
+private:
+    size_t nThreads;
+    size_t concurrentRuns;
+    size_t generations{ 100 };
+    double targetFitness{ 0 };
+};
+
+// One row per run: the parameters, seed, final fitness, time to target,
+// evaluations and evaluations per second
+void writeSweepCsv(std::ostream& os, const std::vector<SweepResult>& results);
+
+#endif // SWEEP_H
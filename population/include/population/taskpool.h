@@ -0,0 +1,65 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One queue of small tasks shared by several independent callers, e.g. the
+// evaluation chunks of concurrent evolution runs. A caller waiting for its tasks
+// runs queued tasks of any caller meanwhile, so callers plus workers never need
+// more threads than there are CPUs.
+class TaskPool
+{
+public:
+    using Task = std::function<void(size_t index)>;
+
+    // Workers only run tasks; with none, the callers do all the work
+    explicit TaskPool(size_t nWorkers = 0);
+    ~TaskPool();
+
+    TaskPool(TaskPool const&) = delete;
+    TaskPool& operator=(TaskPool const&) = delete;
+
+    size_t getNumWorkers() const { return threads.size(); }
+
+    // Runs task(0..n) and returns when all have finished; the calling thread works along.
+    // Tasks must not throw.
+    void run(size_t n, const Task& task);
+
+    // Runs queued tasks until done() holds. done is checked under the pool's lock
+    // and after every task, so state it reads must change before notify().
+    void helpUntil(const std::function<bool()>& done);
+
+    // Wakes helpers to re-check their condition
+    void notify();
+
+private:
+    struct Group
+    {
+        const Task* task;
+        size_t pending;
+    };
+    struct Item
+    {
+        Group* group;
+        size_t index;
+    };
+
+    // Runs one item with the lock released and accounts for it
+    void execute(Item item, std::unique_lock<std::mutex>& lock);
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Item> queue;
+    bool stopping{ false };
+};
+
+#endif // TASKPOOL_H
@@ -0,0 +1,294 @@
+#include "population/cmaes.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// Cyclic Jacobi rotations on the symmetric row-major matrix a, which is destroyed.
+// On return the eigenvectors are the columns of v and the eigenvalues are in d.
+void symmetricEigen(size_t n, std::vector<double>& a, std::vector<double>& v, std::vector<double>& d)
+{
+    v.assign(n * n, 0);
+    for(size_t i = 0; i < n; ++i) {
+        v[i * n + i] = 1;
+    }
+
+    for(int sweep = 0; sweep < 100; ++sweep) {
+        double offDiagonal = 0;
+        double diagonal = 0;
+        for(size_t i = 0; i < n; ++i) {
+            diagonal += a[i * n + i] * a[i * n + i];
+            for(size_t j = i + 1; j < n; ++j) {
+                offDiagonal += a[i * n + j] * a[i * n + j];
+            }
+        }
+        if(offDiagonal <= 1e-30 * diagonal) {
+            break;
+        }
+
+        for(size_t p = 0; p < n; ++p) {
+            for(size_t q = p + 1; q < n; ++q) {
+                const auto apq = a[p * n + q];
+                if(apq == 0) {
+                    continue;
+                }
+                const auto theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+                const auto t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+                const auto c = 1 / std::sqrt(t * t + 1);
+                const auto s = t * c;
+
+                for(size_t k = 0; k < n; ++k) {
+                    const auto akp = a[k * n + p];
+                    const auto akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for(size_t k = 0; k < n; ++k) {
+                    const auto apk = a[p * n + k];
+                    const auto aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for(size_t k = 0; k < n; ++k) {
+                    const auto vkp = v[k * n + p];
+                    const auto vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    d.resize(n);
+    for(size_t i = 0; i < n; ++i) {
+        d[i] = a[i * n + i];
+    }
+}
+
+}
+
+CmaEs::CmaEs(const std::vector<double>& initialMean, double initialSigma, Covariance mode_, unsigned int seed)
+    : n{ initialMean.size() },
+      mode{ mode_ },
+      mean{ initialMean },
+      sigma{ initialSigma },
+      engine{ seed }
+{
+    assert(n > 0);
+    D.assign(n, 1);
+    pc.assign(n, 0);
+    ps.assign(n, 0);
+    if(mode == Covariance::Full) {
+        C.assign(n * n, 0);
+        B.assign(n * n, 0);
+        for(size_t i = 0; i < n; ++i) {
+            C[i * n + i] = 1;
+            B[i * n + i] = 1;
+        }
+    }
+    z.resize(n);
+    tmp.resize(n);
+}
+
+void CmaEs::initParameters(size_t lambda_)
+{
+    lambda = lambda_;
+    mu = std::max<size_t>(1, lambda / 2);
+
+    recombWeights.resize(mu);
+    double sum = 0;
+    for(size_t i = 0; i < mu; ++i) {
+        recombWeights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+        sum += recombWeights[i];
+    }
+    double sumSq = 0;
+    for(auto& w : recombWeights) {
+        w /= sum;
+        sumSq += w * w;
+    }
+    mueff = 1 / sumSq;
+
+    const auto dn = static_cast<double>(n);
+    cc = (4 + mueff / dn) / (dn + 4 + 2 * mueff / dn);
+    cs = (mueff + 2) / (dn + mueff + 5);
+    c1 = 2 / ((dn + 1.3) * (dn + 1.3) + mueff);
+    cmu = std::min(1 - c1, 2 * (mueff - 2 + 1 / mueff) / ((dn + 2) * (dn + 2) + mueff));
+    if(mode == Covariance::Separable) {
+        // Diagonal-only learning can afford faster rates (Ros & Hansen 2008)
+        c1 = std::min(1.0, c1 * (dn + 2) / 3);
+        cmu = std::min(1 - c1, cmu * (dn + 2) / 3);
+    }
+    damps = 1 + 2 * std::max(0.0, std::sqrt((mueff - 1) / (dn + 1)) - 1) + cs;
+    chiN = std::sqrt(dn) * (1 - 1 / (4 * dn) + 1 / (21 * dn * dn));
+}
+
+void CmaEs::sample(PopulationVector& individuals)
+{
+    if(individuals.size() != lambda) {
+        initParameters(individuals.size());
+    }
+
+    std::normal_distribution<double> gauss(0, 1);
+    steps.resize(lambda * n);
+    stepIndex.clear();
+
+    for(size_t k = 0; k < lambda; ++k) {
+        auto genome = individuals[k]->getGenome();
+        assert(genome && genome->size() == n);
+
+        for(auto& zi : z) {
+            zi = gauss(engine);
+        }
+
+        double* y = &steps[k * n];
+        if(mode == Covariance::Full) {
+            // y = B * (D .* z)
+            for(size_t j = 0; j < n; ++j) {
+                tmp[j] = D[j] * z[j];
+            }
+            for(size_t i = 0; i < n; ++i) {
+                const double* row = &B[i * n];
+                double acc = 0;
+                for(size_t j = 0; j < n; ++j) {
+                    acc += row[j] * tmp[j];
+                }
+                y[i] = acc;
+            }
+        }
+        else {
+            for(size_t i = 0; i < n; ++i) {
+                y[i] = D[i] * z[i];
+            }
+        }
+
+        double* x = genome->data();
+        for(size_t i = 0; i < n; ++i) {
+            x[i] = mean[i] + sigma * y[i];
+        }
+        stepIndex[individuals[k].get()] = k;
+    }
+}
+
+void CmaEs::update(const PopulationVector& individuals)
+{
+    assert(individuals.size() == lambda);
+    ++generation;
+
+    // Weighted mean of the mu best steps
+    std::vector<double> yw(n, 0);
+    std::vector<const double*> best(mu);
+    for(size_t i = 0; i < mu; ++i) {
+        best[i] = &steps[stepIndex.at(individuals[i].get()) * n];
+        const auto w = recombWeights[i];
+        for(size_t j = 0; j < n; ++j) {
+            yw[j] += w * best[i][j];
+        }
+    }
+    for(size_t j = 0; j < n; ++j) {
+        mean[j] += sigma * yw[j];
+    }
+
+    // Conjugate evolution path, using C^-1/2 yw = B D^-1 B^T yw
+    const auto csFactor = std::sqrt(cs * (2 - cs) * mueff);
+    if(mode == Covariance::Full) {
+        for(size_t j = 0; j < n; ++j) {
+            tmp[j] = 0;
+        }
+        for(size_t i = 0; i < n; ++i) {
+            const double* row = &B[i * n];
+            for(size_t j = 0; j < n; ++j) {
+                tmp[j] += row[j] * yw[i];
+            }
+        }
+        for(size_t j = 0; j < n; ++j) {
+            tmp[j] /= D[j];
+        }
+        for(size_t i = 0; i < n; ++i) {
+            const double* row = &B[i * n];
+            double acc = 0;
+            for(size_t j = 0; j < n; ++j) {
+                acc += row[j] * tmp[j];
+            }
+            ps[i] = (1 - cs) * ps[i] + csFactor * acc;
+        }
+    }
+    else {
+        for(size_t i = 0; i < n; ++i) {
+            ps[i] = (1 - cs) * ps[i] + csFactor * yw[i] / D[i];
+        }
+    }
+
+    double psNorm = 0;
+    for(const auto p : ps) {
+        psNorm += p * p;
+    }
+    psNorm = std::sqrt(psNorm);
+
+    const auto hsig = psNorm / std::sqrt(1 - std::pow(1 - cs, 2.0 * generation)) / chiN
+                      < 1.4 + 2 / (n + 1.0);
+    const auto ccFactor = hsig ? std::sqrt(cc * (2 - cc) * mueff) : 0.0;
+    for(size_t i = 0; i < n; ++i) {
+        pc[i] = (1 - cc) * pc[i] + ccFactor * yw[i];
+    }
+
+    // Rank-one and rank-mu covariance update
+    const auto deltaHsig = hsig ? 0.0 : cc * (2 - cc);
+    const auto decay = 1 - c1 - cmu + c1 * deltaHsig;
+    if(mode == Covariance::Full) {
+        for(size_t i = 0; i < n; ++i) {
+            double* row = &C[i * n];
+            const auto pci = c1 * pc[i];
+            for(size_t j = 0; j <= i; ++j) {
+                row[j] = decay * row[j] + pci * pc[j];
+            }
+        }
+        for(size_t k = 0; k < mu; ++k) {
+            const double* y = best[k];
+            const auto w = cmu * recombWeights[k];
+            for(size_t i = 0; i < n; ++i) {
+                double* row = &C[i * n];
+                const auto wyi = w * y[i];
+                for(size_t j = 0; j <= i; ++j) {
+                    row[j] += wyi * y[j];
+                }
+            }
+        }
+        for(size_t i = 0; i < n; ++i) {
+            for(size_t j = 0; j < i; ++j) {
+                C[j * n + i] = C[i * n + j];
+            }
+        }
+    }
+    else {
+        for(size_t i = 0; i < n; ++i) {
+            double rankMu = 0;
+            for(size_t k = 0; k < mu; ++k) {
+                rankMu += recombWeights[k] * best[k][i] * best[k][i];
+            }
+            const auto var = decay * D[i] * D[i] + c1 * pc[i] * pc[i] + cmu * rankMu;
+            D[i] = std::sqrt(std::max(var, 1e-300));
+        }
+    }
+
+    sigma *= std::exp((cs / damps) * (psNorm / chiN - 1));
+
+    // The eigendecomposition is O(n^3), so it is only refreshed once C has drifted
+    // enough. The usual threshold counts evaluations, lambda per generation.
+    if(mode == Covariance::Full
+       && (generation - eigenGeneration) * lambda > lambda / ((c1 + cmu) * n * 10)) {
+        decompose();
+    }
+}
+
+void CmaEs::decompose()
+{
+    eigenGeneration = generation;
+    auto a = C;
+    std::vector<double> eigenvalues;
+    symmetricEigen(n, a, B, eigenvalues);
+    for(size_t i = 0; i < n; ++i) {
+        D[i] = std::sqrt(std::max(eigenvalues[i], 1e-300));
+    }
+}
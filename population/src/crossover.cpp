@@ -0,0 +1,88 @@
+#include "population/crossover.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// splitmix64: well mixed bits from consecutive counters
+inline uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+}
+
+void uniformCrossover(const double* a, const double* b, double* child, size_t n, uint64_t seed)
+{
+    // One hashed word supplies the choices for 64 entries
+    for(size_t block = 0; block < n; block += 64) {
+        const auto bits = mix(seed + block / 64);
+        const auto end = std::min(n, block + 64);
+        size_t i = block;
+#if defined(__AVX2__)
+        const auto lanes = _mm256_set_epi64x(8, 4, 2, 1);
+        for(; i + 4 <= end; i += 4) {
+            const auto nibble = _mm256_set1_epi64x(static_cast<long long>(bits >> (i - block)));
+            const auto takeB = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(nibble, lanes), lanes));
+            _mm256_storeu_pd(child + i, _mm256_blendv_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), takeB));
+        }
+#endif
+        for(; i < end; ++i) {
+            child[i] = (bits >> (i - block)) & 1 ? b[i] : a[i];
+        }
+    }
+}
+
+void blendCrossover(const double* a, const double* b, double* child, size_t n, double alpha)
+{
+    for(size_t i = 0; i < n; ++i) {
+        child[i] = a[i] + alpha * (b[i] - a[i]);
+    }
+}
+
+void segmentCrossover(const double* a, const double* b, double* child,
+                      const size_t* bounds, size_t nSegments, uint64_t seed)
+{
+    for(size_t k = 0; k < nSegments; ++k) {
+        assert(bounds[k] <= bounds[k + 1]);
+        const auto source = (mix(seed + k) & 1) ? b : a;
+        if(source != child) {
+            std::memmove(child + bounds[k], source + bounds[k], (bounds[k + 1] - bounds[k]) * sizeof(double));
+        }
+    }
+}
+
+SbxCrossover::SbxCrossover(double eta_) : eta{ eta_ }
+{
+    // beta for u <= 0.5 contracts towards the mean, for u > 0.5 it expands
+    const size_t size = size_t{1} << tableBits;
+    halfSpreads.resize(2 * size);
+    for(size_t k = 0; k < size; ++k) {
+        const auto u = (k + 0.5) / size;
+        const auto beta = u <= 0.5 ? std::pow(2 * u, 1 / (eta + 1))
+                                   : std::pow(1 / (2 * (1 - u)), 1 / (eta + 1));
+        halfSpreads[k] = 0.5 * beta;
+        halfSpreads[size + k] = -0.5 * beta;
+    }
+}
+
+void SbxCrossover::operator()(const double* a, const double* b, double* child, size_t n, uint64_t seed) const
+{
+    // Children are mean +- beta/2 * (a - b)
+    const auto mask = halfSpreads.size() - 1;
+    const double* spreads = halfSpreads.data();
+    for(size_t i = 0; i < n; ++i) {
+        const auto spread = spreads[mix(seed + i) & mask];
+        child[i] = 0.5 * (a[i] + b[i]) + spread * (a[i] - b[i]);
+    }
+}
@@ -0,0 +1,224 @@
+#include "population/metricslog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+const char fileMagic[8] = { 'E', 'V', 'N', 'N', 'M', 'L', '0', '1' };
+
+struct FileHeader
+{
+    char magic[8];
+    uint64_t recordSize;
+};
+
+static_assert(sizeof(GenerationMetrics) == 13 * 8, "metrics records must not hold padding");
+
+// The writer wakes for this many records, or after the interval for fewer
+const size_t batchRecords = 256;
+const auto flushInterval = std::chrono::seconds(1);
+
+// Record size of the log at path, which must be at least a header long
+uint64_t readRecordSize(std::istream& is, const std::string& path)
+{
+    FileHeader header;
+    if(!is.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("metrics log too short: " + path);
+    }
+    if(std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0) {
+        throw std::runtime_error("not a metrics log: " + path);
+    }
+    // Records may grow fields at their end, which older readers skip
+    if(header.recordSize < sizeof(GenerationMetrics)) {
+        throw std::runtime_error("corrupt metrics log: " + path);
+    }
+    return header.recordSize;
+}
+
+}
+
+Summary summarize(std::vector<double>& values)
+{
+    Summary s;
+    if(values.empty()) {
+        return s;
+    }
+    const auto minMax = std::minmax_element(values.begin(), values.end());
+    s.min = *minMax.first;
+    s.max = *minMax.second;
+    s.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+
+    const auto mid = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), mid, values.end());
+    s.median = *mid;
+    if(values.size() % 2 == 0) {
+        s.median = (s.median + *std::max_element(values.begin(), mid)) / 2;
+    }
+    return s;
+}
+
+MetricsLog::MetricsLog(const std::string& path_, bool append) : path{ path_ }
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if(append && !ec && size > 0) {
+        std::ifstream is(path, std::ios::binary);
+        if(readRecordSize(is, path) != sizeof(GenerationMetrics)) {
+            throw std::runtime_error("metrics log has another record layout: " + path);
+        }
+        const auto whole = sizeof(FileHeader) + (size - sizeof(FileHeader)) / sizeof(GenerationMetrics)
+            * sizeof(GenerationMetrics);
+        if(whole != size) {
+            std::filesystem::resize_file(path, whole, ec);
+            if(ec) {
+                throw std::runtime_error("cannot truncate metrics log " + path);
+            }
+        }
+        os.open(path, std::ios::binary | std::ios::app);
+        if(!os) {
+            throw std::runtime_error("cannot open metrics log " + path);
+        }
+    }
+    else {
+        os.open(path, std::ios::binary | std::ios::trunc);
+        if(!os) {
+            throw std::runtime_error("cannot create metrics log " + path);
+        }
+        FileHeader header{};
+        std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+        header.recordSize = sizeof(GenerationMetrics);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if(!os.flush()) {
+            throw std::runtime_error("error writing metrics log " + path);
+        }
+    }
+
+    writer = std::thread(&MetricsLog::writerLoop, this);
+}
+
+MetricsLog::~MetricsLog()
+{
+    stopWriter();
+}
+
+void MetricsLog::log(const GenerationMetrics& metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(stopping) {
+        return;
+    }
+    pending.push_back(metrics);
+    ++numLogged;
+    if(pending.size() == batchRecords) {
+        wake.notify_one();
+    }
+}
+
+void MetricsLog::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if(writer.joinable()) {
+        const auto target = numLogged;
+        flushing = true;
+        wake.notify_one();
+        written.wait(lock, [this, target] { return numWritten >= target; });
+        flushing = false;
+    }
+    if(failed) {
+        throw std::runtime_error("error writing metrics log " + path);
+    }
+}
+
+void MetricsLog::close()
+{
+    stopWriter();
+    if(failed) {
+        throw std::runtime_error("error writing metrics log " + path);
+    }
+}
+
+void MetricsLog::stopWriter()
+{
+    if(!writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    os.close();
+    failed = failed || !os;
+}
+
+void MetricsLog::writerLoop()
+{
+    std::vector<GenerationMetrics> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        wake.wait_for(lock, flushInterval, [this] {
+            return stopping || (!pending.empty() && (flushing || pending.size() >= batchRecords));
+        });
+        if(pending.empty()) {
+            if(stopping) {
+                return;
+            }
+            continue;
+        }
+        // Write outside the lock so that log() never waits for the disk
+        batch.clear();
+        batch.swap(pending);
+        lock.unlock();
+
+        os.write(reinterpret_cast<const char*>(batch.data()),
+                 static_cast<std::streamsize>(batch.size() * sizeof(GenerationMetrics)));
+        os.flush();
+        const bool ok = static_cast<bool>(os);
+
+        lock.lock();
+        failed = failed || !ok;
+        numWritten += batch.size();
+        written.notify_all();
+    }
+}
+
+std::vector<GenerationMetrics> readMetricsLog(const std::string& path)
+{
+    std::ifstream is(path, std::ios::binary);
+    if(!is) {
+        throw std::runtime_error("cannot open metrics log " + path);
+    }
+    const auto recordSize = readRecordSize(is, path);
+
+    std::vector<GenerationMetrics> metrics;
+    std::vector<char> record(recordSize);
+    while(is.read(record.data(), static_cast<std::streamsize>(recordSize))) {
+        metrics.emplace_back();
+        std::memcpy(&metrics.back(), record.data(), sizeof(GenerationMetrics));
+    }
+    return metrics;
+}
+
+void writeMetricsCsv(std::ostream& os, const std::vector<GenerationMetrics>& metrics)
+{
+    os << "generation,evaluations,improvements,elapsed_seconds,generation_seconds,"
+          "best_fitness,median_fitness,worst_fitness,mean_fitness,"
+          "min_stddev,median_stddev,max_stddev,mean_stddev\n";
+    const auto precision = os.precision(std::numeric_limits<double>::digits10);
+    for(const auto& m : metrics) {
+        os << m.generation << "," << m.evaluations << "," << m.improvements << ","
+           << m.elapsedSeconds << "," << m.generationSeconds;
+        for(const auto* s : { &m.fitness, &m.stddev }) {
+            os << "," << s->min << "," << s->median << "," << s->max << "," << s->mean;
+        }
+        os << "\n";
+    }
+    os.precision(precision);
+}
@@ -0,0 +1,221 @@
+#include "population/multiobjective.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <numeric>
+
+bool dominates(const double* a, const double* b, size_t m)
+{
+    bool better = false;
+    for(size_t j = 0; j < m; ++j) {
+        if(a[j] > b[j]) {
+            return false;
+        }
+        better = better || a[j] < b[j];
+    }
+    return better;
+}
+
+namespace {
+
+// Indices of the points in lexicographic order of their objectives. No point
+// can be dominated by one after it.
+std::vector<size_t> lexicographicOrder(const double* objectives, size_t n, size_t m)
+{
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [objectives, m](size_t a, size_t b) {
+        return std::lexicographical_compare(objectives + a * m, objectives + (a + 1) * m,
+                                            objectives + b * m, objectives + (b + 1) * m);
+    });
+    return order;
+}
+
+// First front for which dominated(front) is false; fronts before it all dominate
+template<typename Dominated>
+size_t findFront(size_t nFronts, Dominated dominated)
+{
+    size_t low = 0, high = nFronts;
+    while(low < high) {
+        const auto mid = (low + high) / 2;
+        if(dominated(mid)) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+}
+
+std::vector<size_t> nonDominatedSort(const double* objectives, size_t n, size_t m)
+{
+    std::vector<size_t> fronts(n, 0);
+    const auto order = lexicographicOrder(objectives, n, m);
+
+    if(m == 2) {
+        // In sweep order, a front's last point has its lowest second objective and
+        // dominates a later point exactly if any of the front does
+        std::vector<size_t> lastOfFront;
+        for(const auto p : order) {
+            const auto point = objectives + p * m;
+            const auto front = findFront(lastOfFront.size(), [&](size_t f) {
+                return dominates(objectives + lastOfFront[f] * m, point, m);
+            });
+            if(front == lastOfFront.size()) {
+                lastOfFront.push_back(p);
+            }
+            else {
+                lastOfFront[front] = p;
+            }
+            fronts[p] = front;
+        }
+        return fronts;
+    }
+
+    if(m == 3) {
+        // Earlier points are no worse in the first objective, so domination comes down
+        // to the other two. Each front keeps the staircase of its minimal (f2, f3)
+        // projections: by ascending f2 with descending f3, each with the lowest f1
+        // seen for it. The entry with the largest f2 <= p's has the lowest f3 of all
+        // members at or below p in f2.
+        struct Step
+        {
+            double f3;
+            double f1;
+        };
+        std::vector<std::map<double, Step>> staircases;
+        for(const auto p : order) {
+            const auto point = objectives + p * m;
+            const auto front = findFront(staircases.size(), [&](size_t f) {
+                const auto& stairs = staircases[f];
+                auto it = stairs.upper_bound(point[1]);
+                if(it == stairs.begin()) {
+                    return false;
+                }
+                --it;
+                if(it->second.f3 > point[2]) {
+                    return false;
+                }
+                // An equal projection only dominates with a lower first objective
+                return it->first < point[1] || it->second.f3 < point[2] || it->second.f1 < point[0];
+            });
+            if(front == staircases.size()) {
+                staircases.emplace_back();
+            }
+            auto& stairs = staircases[front];
+            const auto existing = stairs.find(point[1]);
+            if(existing == stairs.end() || existing->second.f3 > point[2]) {
+                const auto it = stairs.insert_or_assign(point[1], Step{ point[2], point[0] }).first;
+                auto next = std::next(it);
+                while(next != stairs.end() && next->second.f3 >= point[2]) {
+                    next = stairs.erase(next);
+                }
+            }
+            fronts[p] = front;
+        }
+        return fronts;
+    }
+
+    // ENS-BS: check the members of a front from the most recently added backwards
+    std::vector<std::vector<size_t>> members;
+    for(const auto p : order) {
+        const auto point = objectives + p * m;
+        const auto front = findFront(members.size(), [&](size_t f) {
+            const auto& front = members[f];
+            for(auto it = front.rbegin(); it != front.rend(); ++it) {
+                if(dominates(objectives + *it * m, point, m)) {
+                    return true;
+                }
+            }
+            return false;
+        });
+        if(front == members.size()) {
+            members.emplace_back();
+        }
+        members[front].push_back(p);
+        fronts[p] = front;
+    }
+    return fronts;
+}
+
+std::vector<double> crowdingDistances(const double* objectives, size_t m, const std::vector<size_t>& front)
+{
+    const auto n = front.size();
+    std::vector<double> distances(n, 0);
+    std::vector<size_t> order(n);
+    for(size_t j = 0; j < m; ++j) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return objectives[front[a] * m + j] < objectives[front[b] * m + j];
+        });
+        const auto low = objectives[front[order.front()] * m + j];
+        const auto high = objectives[front[order.back()] * m + j];
+        distances[order.front()] = std::numeric_limits<double>::infinity();
+        distances[order.back()] = std::numeric_limits<double>::infinity();
+        if(high <= low) {
+            continue;
+        }
+        for(size_t i = 1; i + 1 < n; ++i) {
+            const auto gap = objectives[front[order[i + 1]] * m + j] - objectives[front[order[i - 1]] * m + j];
+            distances[order[i]] += gap / (high - low);
+        }
+    }
+    return distances;
+}
+
+void Nsga2::rank(PopulationVector& individuals, NodeThreadPool*)
+{
+    const auto n = individuals.size();
+    if(n == 0) {
+        return;
+    }
+
+    const auto first = individuals[0]->getObjectives();
+    const auto m = first ? first->size() : 1;
+    objectives.resize(n * m);
+    for(size_t i = 0; i < n; ++i) {
+        const auto values = individuals[i]->getObjectives();
+        if(values) {
+            assert(values->size() == m);
+            std::copy(values->begin(), values->end(), objectives.begin() + i * m);
+        }
+        else {
+            objectives[i * m] = individuals[i]->getFitness();
+        }
+    }
+
+    const auto fronts = nonDominatedSort(objectives.data(), n, m);
+    const auto nFronts = *std::max_element(fronts.begin(), fronts.end()) + 1;
+    std::vector<std::vector<size_t>> members(nFronts);
+    for(size_t i = 0; i < n; ++i) {
+        members[fronts[i]].push_back(i);
+    }
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    for(const auto& front : members) {
+        const auto distances = crowdingDistances(objectives.data(), m, front);
+        std::vector<size_t> byCrowding(front.size());
+        std::iota(byCrowding.begin(), byCrowding.end(), 0);
+        std::stable_sort(byCrowding.begin(), byCrowding.end(), [&distances](size_t a, size_t b) {
+            return distances[a] > distances[b];
+        });
+        for(const auto k : byCrowding) {
+            order.push_back(front[k]);
+        }
+    }
+
+    PopulationVector sorted;
+    sorted.reserve(n);
+    sortedFronts.resize(n);
+    for(size_t r = 0; r < n; ++r) {
+        sortedFronts[r] = fronts[order[r]];
+        sorted.push_back(std::move(individuals[order[r]]));
+    }
+    individuals.swap(sorted);
+}
@@ -0,0 +1,298 @@
+#include "population/novelty.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+// The AVX kernel is compiled for AVX whatever the build flags, and used if the
+// CPU has it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NOVELTY_X86_KERNELS 1
+#endif
+
+namespace {
+
+// Both kernels sum four interleaved partial sums in the same order
+double squaredDistanceScalar(const double* a, const double* b, size_t n)
+{
+    size_t i = 0;
+    // Independent accumulators let the compiler keep them in vector registers
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for(; i + 4 <= n; i += 4) {
+        const auto d0 = a[i] - b[i], d1 = a[i + 1] - b[i + 1];
+        const auto d2 = a[i + 2] - b[i + 2], d3 = a[i + 3] - b[i + 3];
+        s0 += d0 * d0;
+        s1 += d1 * d1;
+        s2 += d2 * d2;
+        s3 += d3 * d3;
+    }
+    double sum = (s0 + s1) + (s2 + s3);
+    for(; i < n; ++i) {
+        const auto d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+#ifdef NOVELTY_X86_KERNELS
+__attribute__((target("avx"))) double squaredDistanceAvx(const double* a, const double* b, size_t n)
+{
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    for(; i + 4 <= n; i += 4) {
+        const auto d = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(d, d));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for(; i < n; ++i) {
+        const auto d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+#endif
+
+using DistanceFunction = double (*)(const double* a, const double* b, size_t n);
+
+DistanceFunction pickSquaredDistance()
+{
+#ifdef NOVELTY_X86_KERNELS
+    if(__builtin_cpu_supports("avx")) {
+        return squaredDistanceAvx;
+    }
+#endif
+    return squaredDistanceScalar;
+}
+
+}
+
+double squaredDistance(const double* a, const double* b, size_t n)
+{
+    static const auto function = pickSquaredDistance();
+    return function(a, b, n);
+}
+
+void offerNeighbor(std::vector<Neighbor>& heap, size_t k, const Neighbor& candidate)
+{
+    if(heap.size() < k) {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end());
+    }
+    else if(k > 0 && candidate.distance < heap.front().distance) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end());
+    }
+}
+
+void VpTree::build(const double* points, size_t n, size_t dim_)
+{
+    dim = dim_;
+    coords.resize(n * dim);
+    ids.resize(n);
+    thresholds.assign(n, 0);
+    splits.assign(n, 0);
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    buildRange(0, n, order, points);
+
+    for(size_t pos = 0; pos < n; ++pos) {
+        ids[pos] = order[pos];
+        std::copy(points + order[pos] * dim, points + (order[pos] + 1) * dim, coords.begin() + pos * dim);
+    }
+}
+
+void VpTree::buildRange(size_t begin, size_t end, std::vector<size_t>& order, const double* points)
+{
+    if(end - begin <= leafSize) {
+        return;
+    }
+
+    // The first point of the range is the vantage point; the rest split at the median distance
+    const auto vantage = points + order[begin] * dim;
+    std::vector<std::pair<double, size_t>> byDistance;
+    byDistance.reserve(end - begin - 1);
+    for(size_t i = begin + 1; i < end; ++i) {
+        byDistance.emplace_back(std::sqrt(squaredDistance(vantage, points + order[i] * dim, dim)), order[i]);
+    }
+    const auto median = byDistance.size() / 2;
+    std::nth_element(byDistance.begin(), byDistance.begin() + median, byDistance.end());
+    for(size_t i = 0; i < byDistance.size(); ++i) {
+        order[begin + 1 + i] = byDistance[i].second;
+    }
+
+    const auto mid = begin + 1 + median;
+    thresholds[begin] = byDistance[median].first;
+    splits[begin] = mid;
+    buildRange(begin + 1, mid, order, points);
+    buildRange(mid, end, order, points);
+}
+
+void VpTree::search(const double* query, size_t k, std::vector<Neighbor>& heap, size_t exclude) const
+{
+    if(!ids.empty()) {
+        searchRange(0, ids.size(), query, k, heap, exclude);
+    }
+}
+
+void VpTree::searchRange(size_t begin, size_t end, const double* query, size_t k,
+                         std::vector<Neighbor>& heap, size_t exclude) const
+{
+    if(end - begin <= leafSize) {
+        for(size_t pos = begin; pos < end; ++pos) {
+            if(ids[pos] != exclude) {
+                const auto d = std::sqrt(squaredDistance(query, &coords[pos * dim], dim));
+                offerNeighbor(heap, k, Neighbor{ d, ids[pos] });
+            }
+        }
+        return;
+    }
+
+    const auto d = std::sqrt(squaredDistance(query, &coords[begin * dim], dim));
+    if(ids[begin] != exclude) {
+        offerNeighbor(heap, k, Neighbor{ d, ids[begin] });
+    }
+
+    const auto threshold = thresholds[begin];
+    const auto mid = splits[begin];
+    const auto radius = [&heap, k]() {
+        return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.front().distance;
+    };
+    // Visit the side holding the query first; the other one only if the ball
+    // around the query with the current k-th distance reaches across the threshold
+    if(d < threshold) {
+        searchRange(begin + 1, mid, query, k, heap, exclude);
+        if(d + radius() >= threshold) {
+            searchRange(mid, end, query, k, heap, exclude);
+        }
+    }
+    else {
+        searchRange(mid, end, query, k, heap, exclude);
+        if(d - radius() <= threshold) {
+            searchRange(begin + 1, mid, query, k, heap, exclude);
+        }
+    }
+}
+
+void NoveltyArchive::add(const double* behavior, size_t dim_)
+{
+    assert(dim == 0 || dim == dim_);
+    dim = dim_;
+    points.insert(points.end(), behavior, behavior + dim);
+
+    const auto pending = size() - indexed;
+    if(pending > std::max<size_t>(32, indexed / 4)) {
+        tree.build(points.data(), size(), dim);
+        indexed = size();
+    }
+}
+
+void NoveltyArchive::search(const double* query, size_t k, std::vector<Neighbor>& heap) const
+{
+    tree.search(query, k, heap);
+    for(size_t i = indexed; i < size(); ++i) {
+        const auto d = std::sqrt(squaredDistance(query, &points[i * dim], dim));
+        offerNeighbor(heap, k, Neighbor{ d, i });
+    }
+}
+
+NoveltySearch::NoveltySearch(size_t k_, size_t archivePerGeneration_, double weight_)
+    : k{ k_ },
+      archivePerGeneration{ archivePerGeneration_ },
+      weight{ weight_ }
+{
+}
+
+void NoveltySearch::rank(PopulationVector& individuals, NodeThreadPool* pool)
+{
+    const auto n = individuals.size();
+    if(n == 0) {
+        return;
+    }
+
+    size_t dim = 0;
+    for(const auto& idv : individuals) {
+        if(const auto behavior = idv->getBehavior()) {
+            dim = behavior->size();
+            break;
+        }
+    }
+    // Individuals without a behavior count as the origin
+    behaviors.assign(n * dim, 0);
+    for(size_t i = 0; i < n; ++i) {
+        if(const auto behavior = individuals[i]->getBehavior()) {
+            assert(behavior->size() == dim);
+            std::copy(behavior->begin(), behavior->end(), behaviors.begin() + i * dim);
+        }
+    }
+    populationTree.build(behaviors.data(), n, dim);
+
+    const auto query = [this, &individuals, dim](size_t i, std::vector<Neighbor>& heap) {
+        heap.clear();
+        const auto behavior = &behaviors[i * dim];
+        populationTree.search(behavior, k, heap, i);
+        archive.search(behavior, k, heap);
+        double sum = 0;
+        for(const auto& neighbor : heap) {
+            sum += neighbor.distance;
+        }
+        individuals[i]->setNovelty(heap.empty() ? 0 : sum / heap.size());
+    };
+
+    if(pool) {
+        std::vector<size_t> firstWorker(pool->getNumNodes() + 1, 0);
+        for(size_t node = 0; node < pool->getNumNodes(); ++node) {
+            firstWorker[node + 1] = firstWorker[node] + pool->getNumWorkers(node);
+        }
+        const auto nWorkersTotal = firstWorker.back();
+        pool->run([&](size_t node, size_t worker, size_t) {
+            std::vector<Neighbor> heap;
+            for(size_t i = firstWorker[node] + worker; i < n; i += nWorkersTotal) {
+                query(i, heap);
+            }
+        });
+    }
+    else {
+        std::vector<Neighbor> heap;
+        for(size_t i = 0; i < n; ++i) {
+            query(i, heap);
+        }
+    }
+
+    std::vector<size_t> byNovelty(n);
+    std::iota(byNovelty.begin(), byNovelty.end(), 0);
+    std::stable_sort(byNovelty.begin(), byNovelty.end(), [&individuals](size_t a, size_t b) {
+        return individuals[a]->getNovelty() > individuals[b]->getNovelty();
+    });
+    for(size_t r = 0; r < std::min(archivePerGeneration, n); ++r) {
+        archive.add(&behaviors[byNovelty[r] * dim], dim);
+    }
+
+    // Blend the ranks rather than the values, which live on unrelated scales
+    std::vector<size_t> byFitness(n);
+    std::iota(byFitness.begin(), byFitness.end(), 0);
+    std::stable_sort(byFitness.begin(), byFitness.end(), [&individuals](size_t a, size_t b) {
+        return individuals[a]->getFitness() < individuals[b]->getFitness();
+    });
+    std::vector<double> key(n, 0);
+    for(size_t r = 0; r < n; ++r) {
+        key[byNovelty[r]] += weight * r;
+        key[byFitness[r]] += (1 - weight) * r;
+    }
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&key](size_t a, size_t b) { return key[a] < key[b]; });
+
+    PopulationVector sorted;
+    sorted.reserve(n);
+    for(const auto i : order) {
+        sorted.push_back(std::move(individuals[i]));
+    }
+    individuals.swap(sorted);
+}
@@ -0,0 +1,142 @@
+#include "population/numa.h"
+
+#include "tracing/trace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+std::vector<int> parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::istringstream is(list);
+    std::string range;
+    while(std::getline(is, range, ',')) {
+        if(range.empty() || range == "\n") {
+            continue;
+        }
+        const auto dash = range.find('-');
+        const auto first = std::stoi(range.substr(0, dash));
+        const auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for(int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> getNumaNodes()
+{
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    const std::string root = "/sys/devices/system/node/";
+    if(const auto dir = opendir(root.c_str())) {
+        while(const auto entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if(name.compare(0, 4, "node") != 0 || name.size() == 4
+               || !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                continue;
+            }
+            std::ifstream is(root + name + "/cpulist");
+            std::string list;
+            if(is && std::getline(is, list)) {
+                auto cpus = parseCpuList(list);
+                if(!cpus.empty()) {
+                    nodes.push_back(NumaNode{ std::stoul(name.substr(4)), std::move(cpus) });
+                }
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#endif
+    if(nodes.empty()) {
+        NumaNode all{ 0, {} };
+        const auto n = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned int cpu = 0; cpu < n; ++cpu) {
+            all.cpus.push_back(static_cast<int>(cpu));
+        }
+        nodes.push_back(std::move(all));
+    }
+    return nodes;
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(const auto cpu : cpus) {
+        if(cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+NodeThreadPool::NodeThreadPool(const std::vector<NumaNode>& nodes, size_t threadsPerNode)
+{
+    for(size_t node = 0; node < nodes.size(); ++node) {
+        workersPerNode.push_back(threadsPerNode ? threadsPerNode : std::max<size_t>(1, nodes[node].cpus.size()));
+    }
+    for(size_t node = 0; node < nodes.size(); ++node) {
+        for(size_t worker = 0; worker < workersPerNode[node]; ++worker) {
+            threads.emplace_back(&NodeThreadPool::workerLoop, this, node, worker, nodes[node].cpus);
+        }
+    }
+}
+
+NodeThreadPool::~NodeThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(auto& t : threads) {
+        t.join();
+    }
+}
+
+void NodeThreadPool::run(const Task& t)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &t;
+    pending = threads.size();
+    ++round;
+    wake.notify_all();
+    done.wait(lock, [this] { return pending == 0; });
+    task = nullptr;
+}
+
+void NodeThreadPool::workerLoop(size_t node, size_t worker, std::vector<int> cpus)
+{
+    pinCurrentThread(cpus);
+    TRACE_THREAD_NAME("node " + std::to_string(node) + " worker " + std::to_string(worker));
+
+    size_t seenRound = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        wake.wait(lock, [this, seenRound] { return stopping || round != seenRound; });
+        if(stopping) {
+            return;
+        }
+        seenRound = round;
+        const auto current = task;
+        lock.unlock();
+        (*current)(node, worker, workersPerNode[node]);
+        lock.lock();
+        if(--pending == 0) {
+            done.notify_all();
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include "population/openaies.h"
+
+#include <cassert>
+#include <cmath>
+
+NoiseTable::NoiseTable(size_t size, unsigned int seed)
+    : noise(size)
+{
+    std::mt19937 engine{ seed };
+    std::normal_distribution<float> gauss(0, 1);
+    for(auto& e : noise) {
+        e = gauss(engine);
+    }
+}
+
+OpenAiEs::OpenAiEs(const std::vector<double>& initialCenter, double sigma_, double learningRate_,
+                   std::shared_ptr<const NoiseTable> table_, unsigned int seed)
+    : center{ initialCenter },
+      sigma{ sigma_ },
+      learningRate{ learningRate_ },
+      table{ std::move(table_) },
+      engine{ seed },
+      gradient(initialCenter.size()),
+      m(initialCenter.size()),
+      v(initialCenter.size())
+{
+    assert(table && table->size() >= center.size());
+}
+
+void OpenAiEs::perturb(size_t offset, double sign, double* out) const
+{
+    const auto eps = table->get(offset);
+    const auto scale = sign * sigma;
+    for(size_t i = 0; i < center.size(); ++i) {
+        out[i] = center[i] + scale * eps[i];
+    }
+}
+
+void OpenAiEs::sample(PopulationVector& individuals)
+{
+    candidates.clear();
+    const auto nPairs = individuals.size() / 2;
+    for(size_t p = 0; p < nPairs; ++p) {
+        const auto offset = table->sampleOffset(engine, center.size());
+        for(size_t k = 0; k < 2; ++k) {
+            const auto& idv = individuals[2 * p + k];
+            const auto sign = k ? -1.0 : 1.0;
+            auto genome = idv->getGenome();
+            assert(genome && genome->size() == center.size());
+            perturb(offset, sign, genome->data());
+            candidates[idv.get()] = Candidate{ offset, sign };
+        }
+    }
+
+    // With an odd population the spare individual tracks the unperturbed center
+    if(individuals.size() % 2) {
+        *individuals.back()->getGenome() = center;
+    }
+}
+
+void OpenAiEs::update(const PopulationVector& individuals)
+{
+    const auto n = center.size();
+    const auto nRanked = individuals.size();
+    if(candidates.empty() || nRanked < 2) {
+        return;
+    }
+
+    // Individuals arrive sorted by ascending fitness; centered utility in [-0.5, 0.5]
+    // with the best (lowest) fitness getting the highest utility
+    std::fill(gradient.begin(), gradient.end(), 0);
+    for(size_t rank = 0; rank < nRanked; ++rank) {
+        const auto it = candidates.find(individuals[rank].get());
+        if(it == candidates.end()) {
+            continue;
+        }
+        const auto utility = 0.5 - static_cast<double>(rank) / (nRanked - 1);
+        const auto weight = utility * it->second.sign;
+        const auto eps = table->get(it->second.offset);
+        for(size_t i = 0; i < n; ++i) {
+            gradient[i] += weight * eps[i];
+        }
+    }
+    const auto scale = 1.0 / (candidates.size() * sigma);
+
+    // Adam ascent on the utility
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    ++step;
+    const auto lr = learningRate * std::sqrt(1 - std::pow(beta2, step)) / (1 - std::pow(beta1, step));
+    for(size_t i = 0; i < n; ++i) {
+        const auto g = gradient[i] * scale;
+        m[i] = beta1 * m[i] + (1 - beta1) * g;
+        v[i] = beta2 * v[i] + (1 - beta2) * g * g;
+        center[i] += lr * m[i] / (std::sqrt(v[i]) + epsilon);
+    }
+}
@@ -1,6 +1,12 @@
 #include "population/population.h"
 
+#include "tracing/trace.h"
+
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <iostream>
 
 Population::Population()
@@ -27,29 +33,344 @@ void Population::addIndividual(std::unique_ptr<Individual>&& idv)
     individuals->emplace_back(std::move(idv));
 }
 
+void Population::setSampleSelector(SampleSelector selector, size_t rescoreInterval_, size_t numElites_)
+{
+    sampleSelector = std::move(selector);
+    rescoreInterval = rescoreInterval_;
+    numElites = numElites_;
+}
+
+StopReason Population::run(RunControl& control, BestSoFar* best)
+{
+    control.start();
+    setRunControl(&control);
+    do {
+        evolve();
+        // Rankings other than by fitness can put the fittest anywhere
+        size_t bestIdx = 0;
+        for(size_t i = 1; i < individuals->size(); ++i) {
+            if((*individuals)[i]->getFitness() < (*individuals)[bestIdx]->getFitness()) {
+                bestIdx = i;
+            }
+        }
+        const auto& fittest = *(*individuals)[bestIdx];
+        if(best) {
+            best->offer(fittest);
+        }
+        if(control.update(fittest.getFitness(), evaluations)) {
+            break;
+        }
+    } while(true);
+    setRunControl(nullptr);
+    return control.getStopReason();
+}
+
+void Population::setCrossoverRate(double rate, unsigned int seed)
+{
+    crossoverRate = rate;
+    crossoverEngine.seed(seed);
+}
+
+void Population::setStrategy(std::unique_ptr<Strategy>&& s)
+{
+    strategy = std::move(s);
+}
+
+void Population::setNumaNodes(const std::vector<NumaNode>& nodes, size_t threadsPerNode, bool firstTouch_)
+{
+    pool = nodes.empty() ? nullptr : std::make_unique<NodeThreadPool>(nodes, threadsPerNode);
+    firstTouch = firstTouch_;
+    homeNode.clear();
+}
+
+void Population::setRanking(std::unique_ptr<Ranking>&& r)
+{
+    ranking = std::move(r);
+}
+
+void Population::setSurrogate(std::unique_ptr<Surrogate>&& s)
+{
+    surrogate = std::move(s);
+}
+
+void Population::assignNodes()
+{
+    const auto nNodes = pool->getNumNodes();
+    const auto n = individuals->size();
+    std::vector<std::vector<size_t>> slots(nNodes);
+    for(size_t i = 0; i < n; ++i) {
+        slots[i * nNodes / n].push_back(i);
+    }
+
+    if(firstTouch) {
+        pool->run([this, &slots](size_t node, size_t worker, size_t nWorkers) {
+            const auto& mine = slots[node];
+            for(size_t k = worker; k < mine.size(); k += nWorkers) {
+                auto& slot = (*individuals)[mine[k]];
+                if(auto copy = slot->clone()) {
+                    slot = std::move(copy);
+                }
+            }
+        });
+    }
+
+    homeNode.clear();
+    for(size_t node = 0; node < nNodes; ++node) {
+        for(const auto i : slots[node]) {
+            homeNode[(*individuals)[i].get()] = node;
+        }
+    }
+}
+
+void Population::evaluateOnNodes(const std::vector<size_t>& indices)
+{
+    nodeMembers.resize(pool->getNumNodes());
+    for(auto& members : nodeMembers) {
+        members.clear();
+    }
+    for(const auto i : indices) {
+        const auto idv = (*individuals)[i].get();
+        nodeMembers[homeNode[idv]].push_back(idv);
+    }
+
+    const auto chunk = std::max<size_t>(1, batchSize);
+    pool->run([this, chunk](size_t node, size_t worker, size_t nWorkers) {
+        const auto& members = nodeMembers[node];
+        for(size_t begin = worker * chunk; begin < members.size(); begin += nWorkers * chunk) {
+            const auto count = std::min(chunk, members.size() - begin);
+            if(!skipIfAborting(&members[begin], count)) {
+                TRACE_SCOPE("evaluateBatch");
+                members[begin]->evaluateBatch(&members[begin], count);
+            }
+        }
+    });
+}
+
+bool Population::skipIfAborting(Individual* const* chunk, size_t n)
+{
+    if(!aborted && !(runControl && runControl->shouldAbort())) {
+        return false;
+    }
+    aborted = true;
+    for(size_t i = 0; i < n; ++i) {
+        chunk[i]->setFitness(std::numeric_limits<double>::infinity());
+    }
+    return true;
+}
+
+void Population::evaluateRange(size_t first, size_t last)
+{
+    std::vector<size_t> indices(last - first);
+    std::iota(indices.begin(), indices.end(), first);
+    evaluateIndices(indices);
+}
+
+void Population::evaluateIndices(const std::vector<size_t>& indices)
+{
+    TRACE_SCOPE("evaluate");
+    for(const auto i : indices) {
+        (*individuals)[i]->setFitness(0);
+    }
+    evaluations += indices.size();
+    if(pool) {
+        evaluateOnNodes(indices);
+        return;
+    }
+    const auto chunk = std::max<size_t>(1, batchSize);
+    if(taskPool) {
+        batch.clear();
+        for(const auto i : indices) {
+            batch.push_back((*individuals)[i].get());
+        }
+        const auto nChunks = (batch.size() + chunk - 1) / chunk;
+        taskPool->run(nChunks, [this, chunk](size_t k) {
+            const auto begin = k * chunk;
+            const auto count = std::min(chunk, batch.size() - begin);
+            if(!skipIfAborting(&batch[begin], count)) {
+                TRACE_SCOPE("evaluateBatch");
+                batch[begin]->evaluateBatch(&batch[begin], count);
+            }
+        });
+        return;
+    }
+    for(size_t begin = 0; begin < indices.size(); begin += chunk) {
+        const auto end = std::min(indices.size(), begin + chunk);
+        batch.clear();
+        for(size_t k = begin; k < end; ++k) {
+            batch.push_back((*individuals)[indices[k]].get());
+        }
+        if(!skipIfAborting(batch.data(), batch.size())) {
+            TRACE_SCOPE("evaluateBatch");
+            batch[0]->evaluateBatch(batch.data(), batch.size());
+        }
+    }
+}
+
+void Population::evaluateScreened(const std::vector<double>& priorFitness)
+{
+    const auto n = individuals->size();
+
+    // The elite is unchanged and always evaluated, like any candidate without a usable prior
+    std::vector<size_t> evaluated{ 0 };
+    std::vector<size_t> candidates;
+    for(size_t i = 1; i < n; ++i) {
+        (std::isfinite(priorFitness[i]) ? candidates : evaluated).push_back(i);
+    }
+    features.resize(n);
+    for(const auto i : candidates) {
+        features[i].assign({ 1.0, priorFitness[i] });
+        (*individuals)[i]->getFeatures(features[i]);
+    }
+
+    const bool screened = surrogate->isReady() && !candidates.empty();
+    std::vector<double> predicted(n, 0);
+    std::vector<size_t> skipped;
+    if(screened) {
+        for(const auto i : candidates) {
+            predicted[i] = surrogate->predict(features[i]);
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [&predicted](size_t a, size_t b) { return predicted[a] < predicted[b]; });
+        const auto nKeep = std::max<size_t>(1, static_cast<size_t>(
+            std::ceil(surrogate->getEvaluateFraction() * candidates.size())));
+        skipped.assign(candidates.begin() + std::min(nKeep, candidates.size()), candidates.end());
+        candidates.resize(std::min(nKeep, candidates.size()));
+    }
+    evaluated.insert(evaluated.end(), candidates.begin(), candidates.end());
+    evaluateIndices(evaluated);
+
+    // Screened-out individuals sort last and get replaced by the next offspring
+    for(const auto i : skipped) {
+        (*individuals)[i]->setFitness(std::numeric_limits<double>::infinity());
+    }
+    // Abandoned evaluations would teach the surrogate infinite fitnesses
+    if(aborted) {
+        return;
+    }
+
+    std::vector<double> predictedKept, actualKept;
+    for(const auto i : candidates) {
+        const auto fitness = (*individuals)[i]->getFitness();
+        surrogate->learn(features[i], fitness);
+        if(screened) {
+            predictedKept.push_back(predicted[i]);
+            actualKept.push_back(fitness);
+        }
+    }
+    surrogate->endGeneration(candidates.size() + skipped.size(), candidates.size(), predictedKept, actualKept);
+}
+
+void Population::rankEvaluated()
+{
+    // Screened-out and abandoned individuals keep the objectives and behavior of
+    // their parent, so they sort last and only the evaluated ones are ranked
+    const auto evaluatedEnd = std::stable_partition(individuals->begin(), individuals->end(),
+        [](const std::unique_ptr<Individual>& idv) { return std::isfinite(idv->getFitness()); });
+    if(evaluatedEnd == individuals->end()) {
+        ranking->rank(*individuals, pool.get());
+        return;
+    }
+    PopulationVector evaluated(std::make_move_iterator(individuals->begin()),
+                               std::make_move_iterator(evaluatedEnd));
+    ranking->rank(evaluated, pool.get());
+    std::move(evaluated.begin(), evaluated.end(), individuals->begin());
+}
+
 void Population::evolve()
 {
-    if(!isFirstGeneration) {
+    TRACE_SCOPE("evolve");
+    if(pool && homeNode.size() != individuals->size()) {
+        assignNodes();
+    }
+    aborted = false;
+
+    if(strategy) {
+        TRACE_SCOPE("sample");
+        strategy->sample(*individuals);
+    }
+    else if(!isFirstGeneration) {
+        TRACE_SCOPE("reproduce");
         const auto halfSize = individuals->size() / 2;
+        priorFitness.resize(individuals->size());
+        for(size_t i = 0; i < individuals->size(); ++i) {
+            priorFitness[i] = (*individuals)[i < 2 * halfSize ? i % halfSize : i]->getFitness();
+        }
+        // All offspring first, so that mates are not yet mutated
+        std::uniform_real_distribution<double> chance(0, 1);
+        std::uniform_int_distribution<size_t> pickMate(0, halfSize > 1 ? halfSize - 2 : 0);
         for(size_t i = 0; i < halfSize; ++i) {
             const auto& parent = (*individuals)[i];
             const auto& offspring = (*individuals)[halfSize + i];
 
-            offspring->mutateFrom(parent.get());
-            if(i != 0) {
-                parent->mutate();
+            bool crossed = false;
+            if(halfSize > 1 && crossoverRate > 0 && chance(crossoverEngine) < crossoverRate) {
+                auto mate = pickMate(crossoverEngine);
+                mate += mate >= i;
+                crossed = offspring->crossoverFrom(parent.get(), (*individuals)[mate].get());
+            }
+            if(!crossed) {
+                offspring->mutateFrom(parent.get());
             }
         }
+        for(size_t i = 1; i < halfSize; ++i) {
+            (*individuals)[i]->mutate();
+        }
     }
 
-    for(const auto& uptr : *individuals) {
-        uptr->setFitness(0);
-        uptr->evaluate();
+    if(sampleSelector) {
+        sampleSelector(false);
     }
 
-    std::sort(individuals->begin(), individuals->end(),
-              [](const std::unique_ptr<Individual>& a,
-              const std::unique_ptr<Individual>& b) { return a->getFitness() < b->getFitness(); } );
+    if(surrogate && !strategy && !isFirstGeneration) {
+        evaluateScreened(priorFitness);
+    }
+    else {
+        evaluateRange(0, individuals->size());
+    }
+
+    const auto byFitness = [](const std::unique_ptr<Individual>& a,
+              const std::unique_ptr<Individual>& b) { return a->getFitness() < b->getFitness(); };
+    {
+        TRACE_SCOPE("rank");
+        if(ranking) {
+            rankEvaluated();
+        }
+        else {
+            std::sort(individuals->begin(), individuals->end(), byFitness);
+        }
+    }
+    if(aborted) {
+        isFirstGeneration = false;
+        ++generation;
+        return;
+    }
+
+    // Memetic step: refined elites only improve, so they stay ahead of the rest.
+    // Strategies rebuild their update from the sampled steps, which would drop the
+    // refinement but still credit its fitness to the unrefined step, so they skip it.
+    const auto nRefine = strategy ? 0 : std::min(numRefined, individuals->size());
+    if(nRefine) {
+        TRACE_SCOPE("refine");
+        for(size_t i = 0; i < nRefine; ++i) {
+            (*individuals)[i]->refine();
+        }
+        evaluateRange(0, nRefine);
+        std::sort(individuals->begin(), individuals->begin() + nRefine, byFitness);
+    }
+
+    // Elites ranked on a mini-batch may just have been lucky, so re-score them on all samples
+    if(sampleSelector && rescoreInterval != 0 && generation % rescoreInterval == 0) {
+        TRACE_SCOPE("rescore");
+        sampleSelector(true);
+        const auto nRescore = std::min(numElites, individuals->size());
+        evaluateRange(0, nRescore);
+        std::sort(individuals->begin(), individuals->begin() + nRescore, byFitness);
+    }
+
+    if(strategy) {
+        strategy->update(*individuals);
+    }
 
     isFirstGeneration = false;
+    ++generation;
 }
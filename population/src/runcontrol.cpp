@@ -0,0 +1,113 @@
+#include "population/runcontrol.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char* toString(StopReason reason)
+{
+    switch(reason) {
+    case StopReason::None: return "none";
+    case StopReason::Generations: return "generations";
+    case StopReason::Evaluations: return "evaluations";
+    case StopReason::Deadline: return "deadline";
+    case StopReason::Target: return "target";
+    case StopReason::Stagnation: return "stagnation";
+    case StopReason::Cancelled: return "cancelled";
+    }
+    return "";
+}
+
+RunControl::RunControl(const StopCriteria& criteria_) : criteria{ criteria_ }
+{
+    start();
+}
+
+void RunControl::start()
+{
+    startTime = Clock::now();
+    deadline = std::isfinite(criteria.maxSeconds)
+        ? startTime + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(criteria.maxSeconds))
+        : Clock::time_point::max();
+    reason = StopReason::None;
+    generations = 0;
+    bestFitness = std::numeric_limits<double>::infinity();
+    referenceFitness = std::numeric_limits<double>::infinity();
+    lastImprovement = 0;
+}
+
+bool RunControl::update(double fitness, size_t evaluations)
+{
+    ++generations;
+    bestFitness = std::min(bestFitness, fitness);
+    if(std::isinf(referenceFitness)
+       || referenceFitness - bestFitness > criteria.minImprovement * std::fabs(referenceFitness)) {
+        referenceFitness = bestFitness;
+        lastImprovement = generations;
+    }
+
+    if(cancelled) {
+        reason = StopReason::Cancelled;
+    }
+    else if(bestFitness <= criteria.targetFitness) {
+        reason = StopReason::Target;
+    }
+    else if(Clock::now() >= deadline) {
+        reason = StopReason::Deadline;
+    }
+    else if(criteria.maxEvaluations && evaluations >= criteria.maxEvaluations) {
+        reason = StopReason::Evaluations;
+    }
+    else if(criteria.maxGenerations && generations >= criteria.maxGenerations) {
+        reason = StopReason::Generations;
+    }
+    else if(criteria.stagnationGenerations && generations - lastImprovement >= criteria.stagnationGenerations) {
+        reason = StopReason::Stagnation;
+    }
+    return reason != StopReason::None;
+}
+
+double RunControl::getElapsedSeconds() const
+{
+    return std::chrono::duration<double>(Clock::now() - startTime).count();
+}
+
+bool BestSoFar::offer(const Individual& idv)
+{
+    const auto f = idv.getFitness();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!(f < fitness)) {
+            return false;
+        }
+    }
+    // Clone outside the lock so readers are not held up
+    std::shared_ptr<const Individual> copy = idv.clone();
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!(f < fitness)) {
+        return false;
+    }
+    fitness = f;
+    if(copy) {
+        best = std::move(copy);
+    }
+    return true;
+}
+
+std::shared_ptr<const Individual> BestSoFar::get() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return best;
+}
+
+double BestSoFar::getFitness() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return fitness;
+}
+
+void BestSoFar::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    best.reset();
+    fitness = std::numeric_limits<double>::infinity();
+}
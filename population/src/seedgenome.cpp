@@ -0,0 +1,212 @@
+#include "population/seedgenome.h"
+
+#include <atomic>
+#include <cassert>
+#include <random>
+
+namespace {
+
+uint64_t nextNodeId()
+{
+    static std::atomic<uint64_t> counter{ 0 };
+    return ++counter;
+}
+
+}
+
+struct SeedGenome::Node
+{
+    uint64_t id;
+    size_t depth;
+    size_t length;
+    std::shared_ptr<const Node> parent;
+    SeedMutation mutation;
+    // Set for depth 0 only; nullptr there means all zeros
+    std::shared_ptr<const std::vector<double>> base;
+    // This node's values as a base of their own, once some descendant rebased
+    // onto it. Guarded by rebaseMutex.
+    mutable std::weak_ptr<const Node> rebased;
+};
+
+bool GenomeCache::find(uint64_t id, std::vector<double>& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = index.find(id);
+    if(it == index.end()) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    out.assign(it->second->second.cbegin(), it->second->second.cend());
+    return true;
+}
+
+void GenomeCache::insert(uint64_t id, const std::vector<double>& genome)
+{
+    if(capacity == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto it = index.find(id);
+    if(it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        it->second->second = genome;
+        return;
+    }
+
+    if(entries.size() < capacity) {
+        entries.emplace_front(id, genome);
+    }
+    else {
+        // Recycle the least recently used entry and its storage
+        index.erase(entries.back().first);
+        entries.splice(entries.begin(), entries, std::prev(entries.end()));
+        entries.front().first = id;
+        entries.front().second.assign(genome.cbegin(), genome.cend());
+    }
+    index[id] = entries.begin();
+}
+
+size_t GenomeCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t GenomeCache::getHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t GenomeCache::getMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+SeedGenome::SeedGenome(std::vector<double> base, size_t maxDepth_)
+    : node{ std::make_shared<const Node>(Node{ nextNodeId(), 0, base.size(), nullptr, SeedMutation{ 0, 0 },
+            std::make_shared<const std::vector<double>>(std::move(base)), {} }) },
+      maxDepth{ maxDepth_ }
+{
+}
+
+SeedGenome::SeedGenome(size_t n, size_t maxDepth_)
+    : node{ std::make_shared<const Node>(Node{ nextNodeId(), 0, n, nullptr, SeedMutation{ 0, 0 }, nullptr, {} }) },
+      maxDepth{ maxDepth_ }
+{
+}
+
+void SeedGenome::mutate(const SeedMutation& mutation, GenomeCache* cache)
+{
+    assert(node);
+    if(node->depth >= maxDepth && node->depth > 0) {
+        rebase(cache);
+    }
+    node = std::make_shared<const Node>(Node{ nextNodeId(), node->depth + 1, node->length, node, mutation,
+                                              nullptr, {} });
+}
+
+void SeedGenome::rebase(GenomeCache* cache)
+{
+    // Keep the newer half of the chain on top of the ancestor below it
+    std::vector<const Node*> kept(node->depth / 2);
+    const Node* ancestor = node.get();
+    for(auto it = kept.rbegin(); it != kept.rend(); ++it) {
+        *it = ancestor;
+        ancestor = ancestor->parent.get();
+    }
+
+    std::shared_ptr<const Node> root;
+    {
+        // Siblings rebasing onto the same ancestor get the same base
+        static std::mutex rebaseMutex;
+        std::lock_guard<std::mutex> lock(rebaseMutex);
+        root = ancestor->rebased.lock();
+        if(!root) {
+            std::vector<double> values;
+            materialize(ancestor, values, cache);
+            // Same values, so the same id keeps cached entries valid
+            root = std::make_shared<const Node>(Node{ ancestor->id, 0, ancestor->length, nullptr,
+                SeedMutation{ 0, 0 }, std::make_shared<const std::vector<double>>(std::move(values)), {} });
+            ancestor->rebased = root;
+        }
+    }
+    for(const auto n : kept) {
+        root = std::make_shared<const Node>(Node{ n->id, root->depth + 1, n->length, root, n->mutation, nullptr, {} });
+    }
+    node = std::move(root);
+}
+
+void SeedGenome::materialize(std::vector<double>& out, GenomeCache* cache) const
+{
+    assert(node);
+    materialize(node.get(), out, cache);
+}
+
+void SeedGenome::materialize(const Node* node, std::vector<double>& out, GenomeCache* cache)
+{
+    // Walk up to the nearest ancestor with known values
+    std::vector<const Node*> path;
+    const Node* n = node;
+    for(;;) {
+        if(cache && cache->find(n->id, out)) {
+            break;
+        }
+        if(n->depth == 0) {
+            if(n->base) {
+                out.assign(n->base->cbegin(), n->base->cend());
+            }
+            else {
+                out.assign(n->length, 0.0);
+            }
+            break;
+        }
+        path.push_back(n);
+        n = n->parent.get();
+    }
+
+    for(auto it = path.crbegin(); it != path.crend(); ++it) {
+        applyMutation((*it)->mutation, out.data(), out.size());
+    }
+    if(cache && !path.empty()) {
+        cache->insert(node->id, out);
+    }
+}
+
+uint64_t SeedGenome::getId() const
+{
+    return node ? node->id : 0;
+}
+
+size_t SeedGenome::getDepth() const
+{
+    return node ? node->depth : 0;
+}
+
+size_t SeedGenome::size() const
+{
+    return node ? node->length : 0;
+}
+
+const std::vector<double>* SeedGenome::getBase() const
+{
+    const Node* n = node.get();
+    while(n && n->depth) {
+        n = n->parent.get();
+    }
+    return n ? n->base.get() : nullptr;
+}
+
+void SeedGenome::applyMutation(const SeedMutation& mutation, double* genome, size_t n)
+{
+    std::mt19937_64 engine{ mutation.seed };
+    std::normal_distribution<double> gauss(0, mutation.stddev);
+    for(size_t i = 0; i < n; ++i) {
+        genome[i] += gauss(engine);
+    }
+}
@@ -0,0 +1,144 @@
+#include "population/surrogate.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+RidgeRegression::RidgeRegression(double lambda_, double forgetting_)
+    : lambda{ lambda_ },
+      forgetting{ forgetting_ }
+{
+}
+
+void RidgeRegression::add(const std::vector<double>& x, double y)
+{
+    const auto d = x.size();
+    if(xty.empty()) {
+        xtx.assign(d * d, 0);
+        xty.assign(d, 0);
+        coefficients.assign(d, 0);
+    }
+    assert(xty.size() == d);
+    for(size_t i = 0; i < d; ++i) {
+        for(size_t j = 0; j < d; ++j) {
+            xtx[i * d + j] += x[i] * x[j];
+        }
+        xty[i] += x[i] * y;
+    }
+    ++samples;
+}
+
+void RidgeRegression::endGeneration()
+{
+    const auto d = xty.size();
+    if(d == 0) {
+        return;
+    }
+
+    // Cholesky factorization of X^T X plus the ridge, then two triangular solves
+    std::vector<double> l(xtx);
+    for(size_t i = 0; i < d; ++i) {
+        l[i * d + i] += lambda * xtx[i * d + i] + 1e-12;
+    }
+    for(size_t j = 0; j < d; ++j) {
+        auto diagonal = l[j * d + j];
+        for(size_t k = 0; k < j; ++k) {
+            diagonal -= l[j * d + k] * l[j * d + k];
+        }
+        if(diagonal <= 0) {
+            return; // not enough data yet, keep the previous fit
+        }
+        l[j * d + j] = std::sqrt(diagonal);
+        for(size_t i = j + 1; i < d; ++i) {
+            auto v = l[i * d + j];
+            for(size_t k = 0; k < j; ++k) {
+                v -= l[i * d + k] * l[j * d + k];
+            }
+            l[i * d + j] = v / l[j * d + j];
+        }
+    }
+    std::vector<double> z(d);
+    for(size_t i = 0; i < d; ++i) {
+        auto v = xty[i];
+        for(size_t k = 0; k < i; ++k) {
+            v -= l[i * d + k] * z[k];
+        }
+        z[i] = v / l[i * d + i];
+    }
+    for(size_t i = d; i-- > 0;) {
+        auto v = z[i];
+        for(size_t k = i + 1; k < d; ++k) {
+            v -= l[k * d + i] * coefficients[k];
+        }
+        coefficients[i] = v / l[i * d + i];
+    }
+
+    for(auto& v : xtx) {
+        v *= forgetting;
+    }
+    for(auto& v : xty) {
+        v *= forgetting;
+    }
+}
+
+double RidgeRegression::predict(const std::vector<double>& x) const
+{
+    assert(coefficients.empty() || coefficients.size() == x.size());
+    double y = 0;
+    for(size_t i = 0; i < coefficients.size(); ++i) {
+        y += coefficients[i] * x[i];
+    }
+    return y;
+}
+
+Surrogate::Surrogate(double evaluateFraction_, size_t warmupSamples_)
+    : evaluateFraction{ evaluateFraction_ },
+      warmupSamples{ warmupSamples_ }
+{
+}
+
+void Surrogate::endGeneration(size_t nCandidates, size_t nEvaluated,
+                              const std::vector<double>& predicted, const std::vector<double>& actual)
+{
+    if(!predicted.empty()) {
+        report.rankCorrelation = (report.rankCorrelation * report.generations + rankCorrelation(predicted, actual))
+                                 / (report.generations + 1);
+        ++report.generations;
+        report.candidates += nCandidates;
+        report.evaluated += nEvaluated;
+    }
+    model.endGeneration();
+}
+
+namespace {
+
+std::vector<double> ranks(const std::vector<double>& values)
+{
+    std::vector<size_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+    std::vector<double> result(values.size());
+    for(size_t r = 0; r < order.size(); ++r) {
+        result[order[r]] = static_cast<double>(r);
+    }
+    return result;
+}
+
+}
+
+double rankCorrelation(const std::vector<double>& a, const std::vector<double>& b)
+{
+    assert(a.size() == b.size());
+    const auto n = static_cast<double>(a.size());
+    if(a.size() < 2) {
+        return 0;
+    }
+    const auto ra = ranks(a);
+    const auto rb = ranks(b);
+    double sumSq = 0;
+    for(size_t i = 0; i < a.size(); ++i) {
+        sumSq += (ra[i] - rb[i]) * (ra[i] - rb[i]);
+    }
+    return 1 - 6 * sumSq / (n * (n * n - 1));
+}
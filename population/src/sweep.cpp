@@ -0,0 +1,188 @@
+#include "population/sweep.h"
+
+#include "population/taskpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+
+double SweepPoint::get(const std::string& name, double fallback) const
+{
+    const auto it = std::find(names.cbegin(), names.cend(), name);
+    return it == names.cend() ? fallback : values[it - names.cbegin()];
+}
+
+SweepSpec& SweepSpec::addValues(const std::string& name, std::vector<double> values)
+{
+    assert(!values.empty());
+    parameters.push_back(Parameter{ name, std::move(values), 0, 0, false });
+    return *this;
+}
+
+SweepSpec& SweepSpec::addRange(const std::string& name, double low, double high, bool logScale)
+{
+    assert(low <= high && (!logScale || low > 0));
+    parameters.push_back(Parameter{ name, {}, low, high, logScale });
+    return *this;
+}
+
+std::vector<SweepPoint> SweepSpec::getGrid(size_t gridSteps, size_t seedsPerPoint, unsigned int seed) const
+{
+    std::vector<std::vector<double>> axes;
+    for(const auto& p : parameters) {
+        if(!p.values.empty()) {
+            axes.push_back(p.values);
+            continue;
+        }
+        std::vector<double> steps;
+        const auto n = std::max<size_t>(1, gridSteps);
+        for(size_t k = 0; k < n; ++k) {
+            const auto t = n > 1 ? static_cast<double>(k) / (n - 1) : 0.5;
+            steps.push_back(p.logScale ? std::exp(std::log(p.low) + t * (std::log(p.high) - std::log(p.low)))
+                                       : p.low + t * (p.high - p.low));
+        }
+        axes.push_back(std::move(steps));
+    }
+
+    std::mt19937 engine(seed);
+    std::vector<SweepPoint> points;
+    // Odometer over the axes, the last one turning fastest
+    std::vector<size_t> digits(axes.size(), 0);
+    for(;;) {
+        SweepPoint point;
+        for(size_t i = 0; i < axes.size(); ++i) {
+            point.names.push_back(parameters[i].name);
+            point.values.push_back(axes[i][digits[i]]);
+        }
+        for(size_t s = 0; s < seedsPerPoint; ++s) {
+            point.seed = engine();
+            points.push_back(point);
+        }
+
+        size_t i = axes.size();
+        while(i > 0 && ++digits[i - 1] == axes[i - 1].size()) {
+            digits[--i] = 0;
+        }
+        if(i == 0) {
+            break;
+        }
+    }
+    return points;
+}
+
+std::vector<SweepPoint> SweepSpec::getRandom(size_t n, unsigned int seed) const
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<SweepPoint> points(n);
+    for(auto& point : points) {
+        for(const auto& p : parameters) {
+            double value;
+            if(!p.values.empty()) {
+                std::uniform_int_distribution<size_t> pick(0, p.values.size() - 1);
+                value = p.values[pick(engine)];
+            }
+            else if(p.logScale) {
+                value = std::exp(std::log(p.low) + uniform(engine) * (std::log(p.high) - std::log(p.low)));
+            }
+            else {
+                value = p.low + uniform(engine) * (p.high - p.low);
+            }
+            point.names.push_back(p.name);
+            point.values.push_back(value);
+        }
+        point.seed = engine();
+    }
+    return points;
+}
+
+SweepRunner::SweepRunner(size_t nThreads_, size_t concurrentRuns_)
+    : nThreads{ nThreads_ ? nThreads_ : std::max(1u, std::thread::hardware_concurrency()) },
+      concurrentRuns{ concurrentRuns_ }
+{
+}
+
+std::vector<SweepResult> SweepRunner::run(const std::vector<SweepPoint>& points, const TrialFactory& factory) const
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto maxDrivers = concurrentRuns ? std::min(concurrentRuns, nThreads) : nThreads;
+    const auto nDrivers = std::max<size_t>(1, std::min(maxDrivers, points.size()));
+    TaskPool pool(nThreads > nDrivers ? nThreads - nDrivers : 0);
+
+    std::vector<SweepResult> results(points.size());
+    std::atomic<size_t> nextPoint{ 0 };
+    std::atomic<size_t> finished{ 0 };
+
+    const auto evolveOne = [&](size_t idx) {
+        auto& result = results[idx];
+        result.point = points[idx];
+        result.timeToTarget = std::numeric_limits<double>::infinity();
+
+        const auto start = Clock::now();
+        const auto elapsed = [&start]() {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+        const auto population = factory(points[idx]);
+        population->setTaskPool(&pool);
+        double best = std::numeric_limits<double>::infinity();
+        for(size_t gen = 0; gen < generations; ++gen) {
+            population->evolve();
+            // Rankings other than by fitness can put the fittest anywhere
+            best = std::numeric_limits<double>::infinity();
+            for(size_t i = 0; i < population->size(); ++i) {
+                best = std::min(best, population->getIndividual(i)->getFitness());
+            }
+            if(best <= targetFitness && std::isinf(result.timeToTarget)) {
+                result.timeToTarget = elapsed();
+            }
+        }
+        result.finalFitness = best;
+        result.evaluations = population->getEvaluations();
+        result.seconds = elapsed();
+    };
+
+    const auto drive = [&]() {
+        for(size_t idx = nextPoint++; idx < points.size(); idx = nextPoint++) {
+            evolveOne(idx);
+            ++finished;
+            pool.notify();
+        }
+        // Out of runs: help the others finish theirs
+        pool.helpUntil([&]() { return finished == points.size(); });
+    };
+
+    std::vector<std::thread> drivers;
+    for(size_t i = 1; i < nDrivers; ++i) {
+        drivers.emplace_back(drive);
+    }
+    drive();
+    for(auto& t : drivers) {
+        t.join();
+    }
+    return results;
+}
+
+void writeSweepCsv(std::ostream& os, const std::vector<SweepResult>& results)
+{
+    const auto& names = results.empty() ? std::vector<std::string>{} : results.front().point.names;
+    for(const auto& name : names) {
+        os << name << ",";
+    }
+    os << "seed,final_fitness,time_to_target,evaluations,evaluations_per_second\n";
+    for(const auto& r : results) {
+        for(const auto v : r.point.values) {
+            os << v << ",";
+        }
+        os << r.point.seed << "," << r.finalFitness << ",";
+        if(std::isfinite(r.timeToTarget)) {
+            os << r.timeToTarget;
+        }
+        os << "," << r.evaluations << "," << r.getEvaluationsPerSecond() << "\n";
+    }
+}
@@ -0,0 +1,92 @@
+#include "population/taskpool.h"
+
+#include "tracing/trace.h"
+
+TaskPool::TaskPool(size_t nWorkers)
+{
+    for(size_t i = 0; i < nWorkers; ++i) {
+        threads.emplace_back(&TaskPool::workerLoop, this);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for(auto& t : threads) {
+        t.join();
+    }
+}
+
+void TaskPool::execute(Item item, std::unique_lock<std::mutex>& lock)
+{
+    lock.unlock();
+    (*item.group->task)(item.index);
+    lock.lock();
+    // Waiters check their group, helpers their condition
+    --item.group->pending;
+    changed.notify_all();
+}
+
+void TaskPool::run(size_t n, const Task& task)
+{
+    if(n == 0) {
+        return;
+    }
+    Group group{ &task, n };
+    std::unique_lock<std::mutex> lock(mutex);
+    for(size_t i = 0; i < n; ++i) {
+        queue.push_back(Item{ &group, i });
+    }
+    changed.notify_all();
+    while(group.pending) {
+        if(queue.empty()) {
+            // Our remaining tasks are running elsewhere
+            changed.wait(lock);
+            continue;
+        }
+        const auto item = queue.front();
+        queue.pop_front();
+        execute(item, lock);
+    }
+}
+
+void TaskPool::helpUntil(const std::function<bool()>& done)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(!done()) {
+        if(queue.empty()) {
+            changed.wait(lock);
+            continue;
+        }
+        const auto item = queue.front();
+        queue.pop_front();
+        execute(item, lock);
+    }
+}
+
+void TaskPool::notify()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    changed.notify_all();
+}
+
+void TaskPool::workerLoop()
+{
+    TRACE_THREAD_NAME("pool worker");
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        changed.wait(lock, [this] { return stopping || !queue.empty(); });
+        if(stopping) {
+            return;
+        }
+        const auto item = queue.front();
+        queue.pop_front();
+        execute(item, lock);
+    }
+}
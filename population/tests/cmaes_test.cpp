@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+
+#include "population/cmaes.h"
+
+#include <memory>
+
+namespace {
+
+// Shifted, badly scaled ellipsoid; minimum 0 at x[i] = 1
+class EllipsoidIndividual : public Individual
+{
+public:
+    explicit EllipsoidIndividual(size_t n) : x(n, 0) {}
+
+    void evaluate() override
+    {
+        for(size_t i = 0; i < x.size(); ++i) {
+            const auto scale = 1.0 + 9.0 * i;
+            fitness += scale * (x[i] - 1) * (x[i] - 1);
+        }
+    }
+
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+
+    std::vector<double>* getGenome() override { return &x; }
+
+    std::vector<double> x;
+};
+
+double runCmaEs(CmaEs::Covariance mode, size_t n, size_t lambda, int generations)
+{
+    Population pop;
+    for(size_t i = 0; i < lambda; ++i) {
+        pop.addIndividual(std::make_unique<EllipsoidIndividual>(n));
+    }
+    pop.setStrategy(std::make_unique<CmaEs>(std::vector<double>(n, 0), 0.5, mode, 42));
+    for(int g = 0; g < generations; ++g) {
+        pop.evolve();
+    }
+    return pop.getIndividual(0)->getFitness();
+}
+
+}
+
+TEST_CASE( "CMA-ES converges on an ellipsoid", "[cmaes]" ) {
+    REQUIRE(runCmaEs(CmaEs::Covariance::Full, 8, 12, 300) < 1e-8);
+}
+
+TEST_CASE( "Separable CMA-ES converges on an ellipsoid", "[cmaes]" ) {
+    REQUIRE(runCmaEs(CmaEs::Covariance::Separable, 20, 16, 400) < 1e-8);
+}
+
+TEST_CASE( "CMA-ES samples are written into the genomes", "[cmaes]" ) {
+    PopulationVector individuals;
+    for(int i = 0; i < 4; ++i) {
+        individuals.emplace_back(std::make_unique<EllipsoidIndividual>(3));
+    }
+    CmaEs es(std::vector<double>(3, 5), 1e-9, CmaEs::Covariance::Full, 1);
+    es.sample(individuals);
+    for(const auto& idv : individuals) {
+        for(const auto v : *idv->getGenome()) {
+            REQUIRE(v == Approx(5));
+        }
+    }
+}
@@ -0,0 +1,173 @@
+#include <catch2/catch.hpp>
+
+#include "population/crossover.h"
+#include "population/population.h"
+#include "population/staticpopulation.h"
+
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+namespace {
+
+void makeParents(std::vector<double>& a, std::vector<double>& b, size_t n)
+{
+    a.resize(n);
+    b.resize(n);
+    std::iota(a.begin(), a.end(), 0.0);
+    std::iota(b.begin(), b.end(), 1000.0);
+}
+
+// Genome (x, y) searching for (3, -2), recombined by blending
+class Pair : public Individual
+{
+public:
+    explicit Pair(unsigned int seed) : engine(seed)
+    {
+        genome = { std::normal_distribution<double>(0, 5)(engine), std::normal_distribution<double>(0, 5)(engine) };
+    }
+
+    void evaluate() override { fitness += std::fabs(genome[0] - 3) + std::fabs(genome[1] + 2); }
+    void mutate() override
+    {
+        for(auto& g : genome) {
+            g += std::normal_distribution<double>(0, 0.1)(engine);
+        }
+    }
+    void mutateFrom(const Individual* other) override
+    {
+        mutateFrom(*dynamic_cast<const Pair*>(other));
+    }
+    void mutateFrom(const Pair& other)
+    {
+        genome = other.genome;
+        mutate();
+    }
+    bool crossoverFrom(const Individual* a, const Individual* b) override
+    {
+        return crossoverFrom(*dynamic_cast<const Pair*>(a), *dynamic_cast<const Pair*>(b));
+    }
+    bool crossoverFrom(const Pair& a, const Pair& b)
+    {
+        REQUIRE(&a != &b);
+        blendCrossover(a.genome.data(), b.genome.data(), genome.data(), genome.size(), 0.5);
+        ++crossovers;
+        mutate();
+        return true;
+    }
+
+    std::vector<double> genome;
+    static int crossovers;
+
+private:
+    std::default_random_engine engine;
+};
+
+int Pair::crossovers = 0;
+
+}
+
+TEST_CASE( "Uniform crossover takes every entry from one parent", "[crossover]" ) {
+    std::vector<double> a, b, child(203);
+    makeParents(a, b, child.size());
+    uniformCrossover(a.data(), b.data(), child.data(), child.size(), 42);
+
+    size_t fromB = 0;
+    for(size_t i = 0; i < child.size(); ++i) {
+        REQUIRE((child[i] == a[i] || child[i] == b[i]));
+        fromB += child[i] == b[i];
+    }
+    REQUIRE(fromB > 70);
+    REQUIRE(fromB < 133);
+
+    std::vector<double> again(child.size());
+    uniformCrossover(a.data(), b.data(), again.data(), again.size(), 42);
+    REQUIRE(again == child);
+    uniformCrossover(a.data(), b.data(), again.data(), again.size(), 43);
+    REQUIRE(again != child);
+}
+
+TEST_CASE( "Blend crossover interpolates", "[crossover]" ) {
+    std::vector<double> a, b, child(7);
+    makeParents(a, b, child.size());
+    blendCrossover(a.data(), b.data(), child.data(), child.size(), 0.25);
+    for(size_t i = 0; i < child.size(); ++i) {
+        REQUIRE(child[i] == Approx(0.75 * a[i] + 0.25 * b[i]));
+    }
+}
+
+TEST_CASE( "Segment crossover swaps whole segments", "[crossover]" ) {
+    std::vector<double> a, b;
+    makeParents(a, b, 10);
+    const size_t bounds[] = { 0, 3, 3, 8, 10 };
+    bool sawA = false, sawB = false;
+    for(uint64_t seed = 0; seed < 8; ++seed) {
+        auto child = a;
+        segmentCrossover(child.data(), b.data(), child.data(), bounds, 4, seed);
+        for(size_t k = 0; k < 4; ++k) {
+            for(size_t i = bounds[k]; i < bounds[k + 1]; ++i) {
+                const auto& source = child[bounds[k]] == a[bounds[k]] ? a : b;
+                REQUIRE(child[i] == source[i]);
+                sawA |= &source == &a;
+                sawB |= &source == &b;
+            }
+        }
+    }
+    REQUIRE(sawA);
+    REQUIRE(sawB);
+}
+
+TEST_CASE( "SBX children spread symmetrically around the parents", "[crossover]" ) {
+    const size_t n = 20000;
+    const std::vector<double> a(n, 1.0), b(n, 3.0);
+    std::vector<double> child(n);
+    const SbxCrossover sbx(2);
+    sbx(a.data(), b.data(), child.data(), n, 7);
+
+    const auto mean = std::accumulate(child.begin(), child.end(), 0.0) / n;
+    REQUIRE(mean == Approx(2).margin(0.05));
+    size_t inside = 0;
+    for(const auto c : child) {
+        inside += c >= 1 && c <= 3;
+    }
+    // Half the draws contract (beta <= 1), half expand
+    REQUIRE(inside / double(n) == Approx(0.5).margin(0.02));
+
+    // A large distribution index keeps children near the parents
+    const SbxCrossover tight(200);
+    tight(a.data(), b.data(), child.data(), n, 7);
+    for(const auto c : child) {
+        REQUIRE((std::fabs(c - 1) < 0.1 || std::fabs(c - 3) < 0.1));
+    }
+}
+
+TEST_CASE( "Population pairs parents for crossover", "[crossover]" ) {
+    Population pop;
+    for(unsigned int i = 0; i < 40; ++i) {
+        pop.addIndividual(std::make_unique<Pair>(i));
+    }
+    pop.setCrossoverRate(0.5, 1);
+    Pair::crossovers = 0;
+    for(int gen = 0; gen < 200; ++gen) {
+        pop.evolve();
+    }
+    // 20 offspring per generation after the first
+    REQUIRE(Pair::crossovers == Approx(0.5 * 20 * 199).epsilon(0.1));
+    const auto& best = *dynamic_cast<const Pair*>(pop.getIndividual(0));
+    REQUIRE(best.genome[0] == Approx(3).margin(0.1));
+    REQUIRE(best.genome[1] == Approx(-2).margin(0.1));
+}
+
+TEST_CASE( "Static population pairs parents for crossover", "[crossover]" ) {
+    StaticPopulation<Pair> pop;
+    for(unsigned int i = 0; i < 40; ++i) {
+        pop.addIndividual(Pair(i));
+    }
+    pop.setCrossoverRate(1, 1);
+    Pair::crossovers = 0;
+    for(int gen = 0; gen < 100; ++gen) {
+        pop.evolve();
+    }
+    REQUIRE(Pair::crossovers == 20 * 99);
+    REQUIRE(pop.getIndividual(0).genome[0] == Approx(3).margin(0.1));
+}
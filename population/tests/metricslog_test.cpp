@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+
+#include "population/metricslog.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+GenerationMetrics makeMetrics(uint64_t generation)
+{
+    GenerationMetrics m;
+    m.generation = generation;
+    m.evaluations = 100 * generation;
+    m.improvements = generation / 3;
+    m.elapsedSeconds = 0.01 * static_cast<double>(generation);
+    m.fitness.min = 1.0 / static_cast<double>(generation + 1);
+    m.stddev.max = 0.25;
+    return m;
+}
+
+}
+
+TEST_CASE( "Summaries of fitness distributions", "[metricslog]" ) {
+    std::vector<double> values{ 5, 1, 4, 2, 3 };
+    auto s = summarize(values);
+    REQUIRE(s.min == 1);
+    REQUIRE(s.median == 3);
+    REQUIRE(s.max == 5);
+    REQUIRE(s.mean == 3);
+
+    values = { 4, 1, 3, 2 };
+    REQUIRE(summarize(values).median == 2.5);
+    values.clear();
+    REQUIRE(summarize(values).max == 0);
+}
+
+TEST_CASE( "Metrics log round trip and append", "[metricslog]" ) {
+    const std::string path = "metricslog_test.bin";
+    {
+        MetricsLog log(path, false);
+        for(uint64_t gen = 1; gen <= 1000; ++gen) {
+            log.log(makeMetrics(gen));
+        }
+        log.flush();
+        REQUIRE(readMetricsLog(path).size() == 1000);
+        log.log(makeMetrics(1001));
+    }
+    {
+        MetricsLog log(path);
+        log.log(makeMetrics(1002));
+        log.close();
+        log.log(makeMetrics(1003));
+    }
+
+    const auto metrics = readMetricsLog(path);
+    REQUIRE(metrics.size() == 1002);
+    for(size_t i = 0; i < metrics.size(); ++i) {
+        const auto expect = makeMetrics(i + 1);
+        REQUIRE(metrics[i].generation == expect.generation);
+        REQUIRE(metrics[i].evaluations == expect.evaluations);
+        REQUIRE(metrics[i].improvements == expect.improvements);
+        REQUIRE(metrics[i].elapsedSeconds == expect.elapsedSeconds);
+        REQUIRE(metrics[i].fitness.min == expect.fitness.min);
+        REQUIRE(metrics[i].stddev.max == expect.stddev.max);
+    }
+
+    std::ostringstream csv;
+    writeMetricsCsv(csv, { metrics[0] });
+    REQUIRE(csv.str() == "generation,evaluations,improvements,elapsed_seconds,generation_seconds,"
+                         "best_fitness,median_fitness,worst_fitness,mean_fitness,"
+                         "min_stddev,median_stddev,max_stddev,mean_stddev\n"
+                         "1,100,0,0.01,0,0.5,0,0,0,0,0,0.25,0\n");
+    std::remove(path.c_str());
+}
+
+TEST_CASE( "A record cut off by a crash is dropped", "[metricslog]" ) {
+    const std::string path = "metricslog_cut_test.bin";
+    {
+        MetricsLog log(path, false);
+        log.log(makeMetrics(1));
+    }
+    {
+        std::ofstream os(path, std::ios::binary | std::ios::app);
+        os << "partial";
+    }
+    REQUIRE(readMetricsLog(path).size() == 1);
+    {
+        MetricsLog log(path);
+        log.log(makeMetrics(2));
+    }
+    const auto metrics = readMetricsLog(path);
+    REQUIRE(metrics.size() == 2);
+    REQUIRE(metrics[1].generation == 2);
+    std::remove(path.c_str());
+}
+
+TEST_CASE( "Files that are not metrics logs are refused", "[metricslog]" ) {
+    const std::string path = "metricslog_bad_test.bin";
+    {
+        std::ofstream os(path);
+        os << "this is not a metrics log";
+    }
+    REQUIRE_THROWS(readMetricsLog(path));
+    REQUIRE_THROWS(MetricsLog(path));
+    REQUIRE_THROWS(readMetricsLog("metricslog_missing_test.bin"));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include "population/multiobjective.h"
+
+#include <cmath>
+#include <random>
+
+namespace {
+
+// Peels off fronts by pairwise dominance checks, O(M N^2) per front
+std::vector<size_t> naiveSort(const std::vector<double>& objectives, size_t m)
+{
+    const auto n = objectives.size() / m;
+    std::vector<size_t> fronts(n, SIZE_MAX);
+    size_t assigned = 0;
+    for(size_t front = 0; assigned < n; ++front) {
+        std::vector<size_t> current;
+        for(size_t i = 0; i < n; ++i) {
+            if(fronts[i] != SIZE_MAX) {
+                continue;
+            }
+            bool dominated = false;
+            for(size_t j = 0; j < n && !dominated; ++j) {
+                dominated = fronts[j] == SIZE_MAX && dominates(&objectives[j * m], &objectives[i * m], m);
+            }
+            if(!dominated) {
+                current.push_back(i);
+            }
+        }
+        for(const auto i : current) {
+            fronts[i] = front;
+        }
+        assigned += current.size();
+    }
+    return fronts;
+}
+
+class MultiObjective : public Individual
+{
+public:
+    explicit MultiObjective(std::vector<double> objectives_) : objectives{ std::move(objectives_) } {}
+
+    void evaluate() override {}
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+    const std::vector<double>* getObjectives() const override { return &objectives; }
+
+    std::vector<double> objectives;
+};
+
+}
+
+TEST_CASE( "Dominance needs one strictly better objective", "[multiobjective]" ) {
+    const double a[2] = { 1, 2 }, b[2] = { 1, 3 }, c[2] = { 0, 4 };
+    REQUIRE(dominates(a, b, 2));
+    REQUIRE(!dominates(b, a, 2));
+    REQUIRE(!dominates(a, a, 2));
+    REQUIRE(!dominates(a, c, 2));
+    REQUIRE(!dominates(c, a, 2));
+}
+
+TEST_CASE( "Non-dominated sort matches the naive sort", "[multiobjective]" ) {
+    std::mt19937 engine(8);
+    // Few distinct values give many ties and duplicate points
+    std::uniform_int_distribution<int> coarse(0, 6);
+    std::uniform_real_distribution<double> fine(0, 1);
+    for(size_t m = 1; m <= 4; ++m) {
+        for(int round = 0; round < 20; ++round) {
+            const size_t n = 1 + round * 7;
+            std::vector<double> objectives(n * m);
+            for(auto& v : objectives) {
+                v = round % 2 ? coarse(engine) : fine(engine);
+            }
+            REQUIRE(nonDominatedSort(objectives.data(), n, m) == naiveSort(objectives, m));
+        }
+    }
+}
+
+TEST_CASE( "Crowding distance favors the boundary and sparse regions", "[multiobjective]" ) {
+    const std::vector<double> objectives{ 0, 4,  1, 3,  1.2, 2.8,  3, 1,  4, 0 };
+    const auto distances = crowdingDistances(objectives.data(), 2, { 0, 1, 2, 3, 4 });
+    REQUIRE(std::isinf(distances[0]));
+    REQUIRE(std::isinf(distances[4]));
+    REQUIRE(distances[3] > distances[1]);
+    REQUIRE(distances[3] > distances[2]);
+}
+
+TEST_CASE( "NSGA-II ranks by front, then by crowding", "[multiobjective]" ) {
+    PopulationVector individuals;
+    individuals.push_back(std::make_unique<MultiObjective>(std::vector<double>{ 2, 2 }));
+    individuals.push_back(std::make_unique<MultiObjective>(std::vector<double>{ 0, 3 }));
+    individuals.push_back(std::make_unique<MultiObjective>(std::vector<double>{ 1, 1 }));
+    individuals.push_back(std::make_unique<MultiObjective>(std::vector<double>{ 3, 0 }));
+    individuals.push_back(std::make_unique<MultiObjective>(std::vector<double>{ 3, 3 }));
+
+    Nsga2 nsga;
+    nsga.rank(individuals);
+    REQUIRE(nsga.getFronts() == std::vector<size_t>{ 0, 0, 0, 1, 2 });
+    // The middle point of the first front is the most crowded
+    REQUIRE(dynamic_cast<MultiObjective*>(individuals[2].get())->objectives == std::vector<double>{ 1, 1 });
+    REQUIRE(dynamic_cast<MultiObjective*>(individuals[3].get())->objectives == std::vector<double>{ 2, 2 });
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include "population/mutation.h"
+
+#include <algorithm>
+
+TEST_CASE( "Sparse indices are ascending, distinct and in range", "[mutation]" ) {
+    std::default_random_engine engine(3);
+    std::vector<size_t> indices;
+    for(int k = 0; k < 100; ++k) {
+        sampleSparseIndices(50, 0.2, engine, indices);
+        REQUIRE(std::adjacent_find(indices.cbegin(), indices.cend(),
+                    [](size_t a, size_t b) { return a >= b; }) == indices.cend());
+        REQUIRE(!indices.empty());
+        REQUIRE(indices.back() < 50);
+    }
+}
+
+TEST_CASE( "Sparse index count matches the pick probability", "[mutation]" ) {
+    std::default_random_engine engine(5);
+    std::vector<size_t> indices;
+    const size_t n = 100000;
+    size_t total = 0;
+    for(int k = 0; k < 20; ++k) {
+        sampleSparseIndices(n, 0.001, engine, indices);
+        total += indices.size();
+    }
+    REQUIRE(total / 20.0 == Approx(100).epsilon(0.1));
+}
+
+TEST_CASE( "Sparse index edge probabilities", "[mutation]" ) {
+    std::default_random_engine engine(7);
+    std::vector<size_t> indices;
+    sampleSparseIndices(10, 0, engine, indices);
+    REQUIRE(indices.empty());
+    sampleSparseIndices(10, 1, engine, indices);
+    REQUIRE(indices.size() == 10);
+    sampleSparseIndices(0, 0.5, engine, indices);
+    REQUIRE(indices.empty());
+}
+
+TEST_CASE( "Sparse indices never come out empty", "[mutation]" ) {
+    // With p = 1/n, about a third of plain Bernoulli draws would pick nothing
+    std::default_random_engine engine(9);
+    std::vector<size_t> indices;
+    std::vector<int> hits(10, 0);
+    for(int k = 0; k < 1000; ++k) {
+        sampleSparseIndices(10, 0.1, engine, indices);
+        REQUIRE(!indices.empty());
+        for(const auto i : indices) {
+            ++hits[i];
+        }
+    }
+    REQUIRE(*std::min_element(hits.begin(), hits.end()) > 0);
+}
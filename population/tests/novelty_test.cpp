@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+
+#include "population/novelty.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+std::vector<double> bruteForce(const std::vector<double>& points, size_t dim, const double* query,
+                               size_t k, size_t exclude)
+{
+    std::vector<double> distances;
+    for(size_t i = 0; i < points.size() / dim; ++i) {
+        if(i != exclude) {
+            distances.push_back(std::sqrt(squaredDistance(query, &points[i * dim], dim)));
+        }
+    }
+    std::sort(distances.begin(), distances.end());
+    distances.resize(std::min(k, distances.size()));
+    return distances;
+}
+
+std::vector<double> sortedDistances(std::vector<Neighbor> heap)
+{
+    std::sort_heap(heap.begin(), heap.end());
+    std::vector<double> distances;
+    for(const auto& neighbor : heap) {
+        distances.push_back(neighbor.distance);
+    }
+    return distances;
+}
+
+class Behaving : public Individual
+{
+public:
+    explicit Behaving(std::vector<double> behavior_) : behavior{ std::move(behavior_) } {}
+
+    void evaluate() override {}
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+    const std::vector<double>* getBehavior() const override { return &behavior; }
+
+    std::vector<double> behavior;
+};
+
+}
+
+TEST_CASE( "Squared distance matches the plain sum", "[novelty]" ) {
+    // Lengths around the 4-wide blocks exercise the tail of whichever kernel runs
+    for(size_t n : { 0, 1, 3, 4, 5, 8, 13 }) {
+        std::vector<double> a(n), b(n);
+        double expected = 0;
+        for(size_t i = 0; i < n; ++i) {
+            a[i] = i * 0.5;
+            b[i] = 3.0 - i;
+            expected += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        REQUIRE(squaredDistance(a.data(), b.data(), n) == Approx(expected));
+    }
+}
+
+TEST_CASE( "VP-tree finds the exact k nearest neighbors", "[novelty]" ) {
+    std::mt19937 engine(9);
+    std::normal_distribution<double> gauss(0, 1);
+    const size_t dim = 7, n = 500, k = 10;
+    std::vector<double> points(n * dim);
+    for(auto& p : points) {
+        p = gauss(engine);
+    }
+    VpTree tree;
+    tree.build(points.data(), n, dim);
+    REQUIRE(tree.size() == n);
+
+    std::vector<Neighbor> heap;
+    for(size_t q = 0; q < 50; ++q) {
+        heap.clear();
+        tree.search(&points[q * dim], k, heap, q);
+        REQUIRE(sortedDistances(heap) == bruteForce(points, dim, &points[q * dim], k, q));
+    }
+}
+
+TEST_CASE( "Archive queries cover indexed and pending entries", "[novelty]" ) {
+    std::mt19937 engine(4);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    const size_t dim = 3;
+    NoveltyArchive archive;
+    std::vector<double> points;
+    std::vector<Neighbor> heap;
+    for(size_t i = 0; i < 300; ++i) {
+        const double p[dim] = { uniform(engine), uniform(engine), uniform(engine) };
+        archive.add(p, dim);
+        points.insert(points.end(), p, p + dim);
+
+        const double query[dim] = { uniform(engine), uniform(engine), uniform(engine) };
+        heap.clear();
+        archive.search(query, 5, heap);
+        REQUIRE(sortedDistances(heap) == bruteForce(points, dim, query, 5, SIZE_MAX));
+    }
+    REQUIRE(archive.size() == 300);
+}
+
+TEST_CASE( "Novelty search ranks the outlier first and archives it", "[novelty]" ) {
+    PopulationVector individuals;
+    for(int i = 0; i < 10; ++i) {
+        individuals.push_back(std::make_unique<Behaving>(std::vector<double>{ i * 0.01, 0 }));
+    }
+    individuals.push_back(std::make_unique<Behaving>(std::vector<double>{ 5, 5 }));
+
+    NoveltySearch novelty(3, 1);
+    novelty.rank(individuals);
+    const auto top = dynamic_cast<Behaving*>(individuals[0].get());
+    REQUIRE(top->behavior[0] == 5);
+    REQUIRE(top->getNovelty() > individuals[1]->getNovelty());
+    REQUIRE(novelty.getArchive().size() == 1);
+
+    // A second round counts the archived copy of the outlier as a close neighbor
+    const auto before = top->getNovelty();
+    novelty.rank(individuals);
+    REQUIRE(individuals[0]->getNovelty() < before);
+}
+
+TEST_CASE( "Parallel novelty queries give the same novelties", "[novelty]" ) {
+    std::mt19937 engine(2);
+    std::normal_distribution<double> gauss(0, 1);
+    PopulationVector serial, parallel;
+    for(int i = 0; i < 200; ++i) {
+        std::vector<double> behavior{ gauss(engine), gauss(engine), gauss(engine), gauss(engine) };
+        serial.push_back(std::make_unique<Behaving>(behavior));
+        parallel.push_back(std::make_unique<Behaving>(behavior));
+    }
+    NoveltySearch a(5, 2), b(5, 2);
+    const auto cpus = getNumaNodes()[0].cpus;
+    NodeThreadPool pool({ NumaNode{ 0, cpus }, NumaNode{ 1, cpus } }, 2);
+    a.rank(serial);
+    b.rank(parallel, &pool);
+    for(size_t i = 0; i < serial.size(); ++i) {
+        REQUIRE(serial[i]->getNovelty() == parallel[i]->getNovelty());
+    }
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+
+#include "population/population.h"
+
+#include <atomic>
+
+TEST_CASE( "CPU lists are parsed", "[numa]" ) {
+    REQUIRE(parseCpuList("0-3,8,10-11\n") == std::vector<int>{ 0, 1, 2, 3, 8, 10, 11 });
+    REQUIRE(parseCpuList("5") == std::vector<int>{ 5 });
+    REQUIRE(parseCpuList("").empty());
+}
+
+TEST_CASE( "There is at least one NUMA node with CPUs", "[numa]" ) {
+    const auto nodes = getNumaNodes();
+    REQUIRE(!nodes.empty());
+    REQUIRE(!nodes[0].cpus.empty());
+}
+
+TEST_CASE( "Node thread pool runs every worker once per call", "[numa]" ) {
+    const auto cpus = getNumaNodes()[0].cpus;
+    NodeThreadPool pool({ NumaNode{ 0, cpus }, NumaNode{ 1, cpus } }, 3);
+    REQUIRE(pool.getNumNodes() == 2);
+    for(int round = 0; round < 5; ++round) {
+        // Catch assertions are not thread-safe, so only count in the workers
+        std::atomic<int> calls{ 0 };
+        std::atomic<int> nodeSum{ 0 };
+        std::atomic<int> workerSum{ 0 };
+        std::atomic<int> bad{ 0 };
+        pool.run([&](size_t node, size_t worker, size_t nWorkers) {
+            bad += nWorkers != 3;
+            ++calls;
+            nodeSum += static_cast<int>(node);
+            workerSum += static_cast<int>(worker);
+        });
+        REQUIRE(bad == 0);
+        REQUIRE(calls == 6);
+        REQUIRE(nodeSum == 3);
+        REQUIRE(workerSum == 6);
+    }
+}
+
+namespace {
+
+class Cloneable : public Individual
+{
+public:
+    void evaluate() override { fitness += 1; ++evaluations; }
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+    std::unique_ptr<Individual> clone() const override
+    {
+        ++clones;
+        return std::make_unique<Cloneable>(*this);
+    }
+
+    static std::atomic<int> evaluations;
+    static std::atomic<int> clones;
+};
+
+std::atomic<int> Cloneable::evaluations{ 0 };
+std::atomic<int> Cloneable::clones{ 0 };
+
+}
+
+TEST_CASE( "Population evaluates each individual once on its node", "[numa]" ) {
+    Population pop;
+    for(int i = 0; i < 37; ++i) {
+        pop.addIndividual(std::make_unique<Cloneable>());
+    }
+    const auto cpus = getNumaNodes()[0].cpus;
+    pop.setNumaNodes({ NumaNode{ 0, cpus }, NumaNode{ 1, cpus } }, 2);
+    pop.setBatchSize(4);
+
+    Cloneable::evaluations = 0;
+    Cloneable::clones = 0;
+    pop.evolve();
+    // First touch replaced every individual by a copy made on its node, once
+    REQUIRE(Cloneable::clones == 37);
+    REQUIRE(Cloneable::evaluations == 37);
+    for(size_t i = 0; i < pop.size(); ++i) {
+        REQUIRE(pop.getIndividual(i)->getFitness() == 1);
+    }
+
+    pop.evolve();
+    REQUIRE(Cloneable::clones == 37);
+    REQUIRE(Cloneable::evaluations == 74);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+
+#include "population/openaies.h"
+
+#include <memory>
+
+namespace {
+
+// Minimum 0 at x[i] = 1
+class SphereIndividual : public Individual
+{
+public:
+    explicit SphereIndividual(size_t n) : x(n, 0) {}
+
+    void evaluate() override
+    {
+        for(const auto xi : x) {
+            fitness += (xi - 1) * (xi - 1);
+        }
+    }
+
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+
+    std::vector<double>* getGenome() override { return &x; }
+
+    std::vector<double> x;
+};
+
+}
+
+TEST_CASE( "Noise table is reproducible from its seed", "[openaies]" ) {
+    NoiseTable a(1000, 7), b(1000, 7);
+    for(size_t i = 0; i < 1000; ++i) {
+        REQUIRE(a.get(0)[i] == b.get(0)[i]);
+    }
+}
+
+TEST_CASE( "Candidates are antithetic pairs around the center", "[openaies]" ) {
+    auto table = std::make_shared<NoiseTable>(1000, 1);
+    OpenAiEs es(std::vector<double>(5, 2.0), 0.1, 0.01, table, 3);
+    PopulationVector individuals;
+    for(int i = 0; i < 5; ++i) {
+        individuals.emplace_back(std::make_unique<SphereIndividual>(5));
+    }
+    es.sample(individuals);
+    for(size_t i = 0; i < 5; ++i) {
+        const auto plus = (*individuals[0]->getGenome())[i];
+        const auto minus = (*individuals[1]->getGenome())[i];
+        REQUIRE(plus + minus == Approx(4.0));
+        REQUIRE((*individuals[4]->getGenome())[i] == 2.0);
+    }
+}
+
+TEST_CASE( "OpenAI-ES descends on a sphere", "[openaies]" ) {
+    const size_t n = 10;
+    Population pop;
+    for(int i = 0; i < 40; ++i) {
+        pop.addIndividual(std::make_unique<SphereIndividual>(n));
+    }
+    auto table = std::make_shared<NoiseTable>(100000, 1);
+    auto es = std::make_unique<OpenAiEs>(std::vector<double>(n, 0), 0.05, 0.02, table, 5);
+    const auto esPtr = es.get();
+    pop.setStrategy(std::move(es));
+    for(int g = 0; g < 300; ++g) {
+        pop.evolve();
+    }
+
+    double distance = 0;
+    for(const auto c : esPtr->getCenter()) {
+        distance += (c - 1) * (c - 1);
+    }
+    REQUIRE(distance < 0.01);
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+
+#include "population/population.h"
+
+#include <memory>
+
+namespace {
+
+class Counting : public Individual
+{
+public:
+    explicit Counting(std::vector<size_t>& batchSizes_) : batchSizes{ &batchSizes_ } {}
+
+    void evaluate() override { fitness += 1; }
+    void evaluateBatch(Individual* const* batch, size_t n) override
+    {
+        batchSizes->push_back(n);
+        Individual::evaluateBatch(batch, n);
+    }
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+
+private:
+    std::vector<size_t>* batchSizes;
+};
+
+class Refined : public Individual
+{
+public:
+    void evaluate() override { fitness += 1; }
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+    void refine() override { ++refinements; }
+
+    int refinements{ 0 };
+};
+
+class KeepAll : public Strategy
+{
+public:
+    void sample(PopulationVector&) override {}
+    void update(const PopulationVector&) override {}
+};
+
+}
+
+TEST_CASE( "Population evaluates in chunks of the batch size", "[population]" ) {
+    std::vector<size_t> batchSizes;
+    Population pop;
+    for(int i = 0; i < 10; ++i) {
+        pop.addIndividual(std::make_unique<Counting>(batchSizes));
+    }
+    pop.setBatchSize(4);
+    pop.evolve();
+
+    REQUIRE(batchSizes == std::vector<size_t>{ 4, 4, 2 });
+    for(size_t i = 0; i < pop.size(); ++i) {
+        REQUIRE(pop.getIndividual(i)->getFitness() == 1);
+    }
+}
+
+TEST_CASE( "Population refines elites except under a strategy", "[population]" ) {
+    const auto countRefinements = [](bool withStrategy) {
+        Population pop;
+        for(int i = 0; i < 4; ++i) {
+            pop.addIndividual(std::make_unique<Refined>());
+        }
+        if(withStrategy) {
+            pop.setStrategy(std::make_unique<KeepAll>());
+        }
+        pop.setNumRefined(1);
+        pop.evolve();
+        int refinements = 0;
+        for(size_t i = 0; i < pop.size(); ++i) {
+            refinements += dynamic_cast<Refined*>(pop.getIndividual(i))->refinements;
+        }
+        return refinements;
+    };
+    REQUIRE(countRefinements(false) == 1);
+    REQUIRE(countRefinements(true) == 0);
+}
@@ -0,0 +1,195 @@
+#include <catch2/catch.hpp>
+
+#include "population/population.h"
+#include "population/runcontrol.h"
+#include "population/staticpopulation.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace {
+
+// Searches for x = 3; evaluation may be made slow
+class Target : public Individual
+{
+public:
+    Target(double x_, unsigned int seed, int sleepMicroseconds_ = 0)
+        : x{ x_ }, sleepMicroseconds{ sleepMicroseconds_ }, engine(seed) {}
+
+    void evaluate() override
+    {
+        if(sleepMicroseconds) {
+            std::this_thread::sleep_for(std::chrono::microseconds(sleepMicroseconds));
+        }
+        fitness += std::fabs(x - 3);
+    }
+    void mutate() override { x += std::normal_distribution<double>(0, 0.1)(engine); }
+    void mutateFrom(const Individual* other) override
+    {
+        mutateFrom(*dynamic_cast<const Target*>(other));
+    }
+    void mutateFrom(const Target& other)
+    {
+        x = other.x;
+        mutate();
+    }
+    std::unique_ptr<Individual> clone() const override { return std::make_unique<Target>(*this); }
+
+    double x;
+
+private:
+    int sleepMicroseconds;
+    std::default_random_engine engine;
+};
+
+void fill(Population& pop, size_t n, int sleepMicroseconds = 0)
+{
+    for(unsigned int i = 0; i < n; ++i) {
+        pop.addIndividual(std::make_unique<Target>(-5.0 + i * 0.1, i, sleepMicroseconds));
+    }
+}
+
+}
+
+TEST_CASE( "Run control stops at the first criterion met", "[runcontrol]" ) {
+    StopCriteria criteria;
+    criteria.maxGenerations = 5;
+    criteria.maxEvaluations = 100;
+    criteria.targetFitness = 0.5;
+    RunControl control(criteria);
+    REQUIRE(!control.update(2, 10));
+    REQUIRE(!control.update(1, 20));
+    REQUIRE(control.update(0.5, 30));
+    REQUIRE(control.getStopReason() == StopReason::Target);
+
+    control.start();
+    REQUIRE(control.getGenerations() == 0);
+    REQUIRE(!control.update(2, 10));
+    REQUIRE(control.update(2, 100));
+    REQUIRE(control.getStopReason() == StopReason::Evaluations);
+
+    control.start();
+    for(int gen = 0; gen < 4; ++gen) {
+        REQUIRE(!control.update(2, 0));
+    }
+    REQUIRE(control.update(2, 0));
+    REQUIRE(control.getStopReason() == StopReason::Generations);
+    REQUIRE(std::string(toString(control.getStopReason())) == "generations");
+}
+
+TEST_CASE( "Run control detects stagnation", "[runcontrol]" ) {
+    StopCriteria criteria;
+    criteria.stagnationGenerations = 3;
+    criteria.minImprovement = 0.1;
+    RunControl control(criteria);
+    REQUIRE(!control.update(10, 0));
+    REQUIRE(!control.update(9.5, 0)); // too small to count
+    REQUIRE(!control.update(8.5, 0)); // 15% below 10 counts
+    REQUIRE(!control.update(8.4, 0));
+    REQUIRE(!control.update(8.3, 0));
+    REQUIRE(control.update(8.2, 0));
+    REQUIRE(control.getStopReason() == StopReason::Stagnation);
+    REQUIRE(control.getBestFitness() == 8.2);
+}
+
+TEST_CASE( "Run control deadline and cancellation", "[runcontrol]" ) {
+    StopCriteria criteria;
+    REQUIRE(!RunControl(criteria).shouldAbort());
+
+    criteria.maxSeconds = 0;
+    RunControl expired(criteria);
+    REQUIRE(expired.shouldAbort());
+    REQUIRE(expired.update(1, 0));
+    REQUIRE(expired.getStopReason() == StopReason::Deadline);
+
+    RunControl control;
+    control.cancel();
+    REQUIRE(control.shouldAbort());
+    REQUIRE(control.update(1, 0));
+    REQUIRE(control.getStopReason() == StopReason::Cancelled);
+}
+
+TEST_CASE( "Best so far keeps a copy of the fittest", "[runcontrol]" ) {
+    BestSoFar best;
+    REQUIRE(best.get() == nullptr);
+    Target a(1, 0), b(2, 0);
+    a.setFitness(2);
+    b.setFitness(1);
+    REQUIRE(best.offer(a));
+    REQUIRE(best.offer(b));
+    REQUIRE(!best.offer(a));
+    b.x = 100;
+    REQUIRE(best.getFitness() == 1);
+    REQUIRE(dynamic_cast<const Target&>(*best.get()).x == 2);
+}
+
+TEST_CASE( "Population runs until a criterion is met", "[runcontrol]" ) {
+    Population pop;
+    fill(pop, 20);
+    StopCriteria criteria;
+    criteria.maxGenerations = 1000;
+    criteria.targetFitness = 0.01;
+    RunControl control(criteria);
+    BestSoFar best;
+    REQUIRE(pop.run(control, &best) == StopReason::Target);
+    REQUIRE(control.getGenerations() < 1000);
+    REQUIRE(best.getFitness() <= 0.01);
+    REQUIRE(dynamic_cast<const Target&>(*best.get()).x == Approx(3).margin(0.01));
+
+    criteria = StopCriteria{};
+    criteria.maxEvaluations = 200;
+    RunControl budget(criteria);
+    REQUIRE(pop.run(budget) == StopReason::Evaluations);
+}
+
+TEST_CASE( "Deadline abandons a generation under way", "[runcontrol]" ) {
+    Population pop;
+    fill(pop, 40, 2000);
+    pop.setBatchSize(4);
+    StopCriteria criteria;
+    criteria.maxSeconds = 0.03;
+    RunControl control(criteria);
+    REQUIRE(pop.run(control) == StopReason::Deadline);
+    // The first generation alone would take 80 ms
+    REQUIRE(control.getGenerations() == 1);
+    REQUIRE(std::isinf(pop.getIndividual(pop.size() - 1)->getFitness()));
+    REQUIRE(std::isfinite(pop.getIndividual(0)->getFitness()));
+}
+
+TEST_CASE( "Run can be cancelled and read from another thread", "[runcontrol]" ) {
+    Population pop;
+    fill(pop, 20, 100);
+    RunControl control;
+    BestSoFar best;
+    std::thread runner([&]() { pop.run(control, &best); });
+
+    while(!best.get()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto snapshot = best.get();
+    const auto fitness = snapshot->getFitness();
+    control.cancel();
+    runner.join();
+
+    REQUIRE(control.getStopReason() == StopReason::Cancelled);
+    REQUIRE(best.getFitness() <= fitness);
+}
+
+TEST_CASE( "Static population abandons generations too", "[runcontrol]" ) {
+    StaticPopulation<Target> pop;
+    for(unsigned int i = 0; i < 10; ++i) {
+        pop.addIndividual(Target(i, i));
+    }
+    RunControl control;
+    pop.setRunControl(&control);
+    pop.evolve();
+    REQUIRE(pop.getEvaluations() == 10);
+    REQUIRE(std::isfinite(pop.getIndividual(9).getFitness()));
+
+    control.cancel();
+    pop.evolve();
+    REQUIRE(std::isinf(pop.getIndividual(0).getFitness()));
+}
@@ -0,0 +1,156 @@
+#include <catch2/catch.hpp>
+
+#include "population/seedgenome.h"
+
+#include <thread>
+
+namespace {
+
+std::vector<double> replay(std::vector<double> base, const std::vector<SeedMutation>& chain)
+{
+    for(const auto& m : chain) {
+        SeedGenome::applyMutation(m, base.data(), base.size());
+    }
+    return base;
+}
+
+}
+
+TEST_CASE( "Seeded mutation is reproducible", "[seedgenome]" ) {
+    std::vector<double> a(10, 1.0), b(10, 1.0);
+    SeedGenome::applyMutation(SeedMutation{ 99, 0.5 }, a.data(), a.size());
+    SeedGenome::applyMutation(SeedMutation{ 99, 0.5 }, b.data(), b.size());
+    REQUIRE(a == b);
+    REQUIRE(a != std::vector<double>(10, 1.0));
+}
+
+TEST_CASE( "Materialized genome replays the mutation chain", "[seedgenome]" ) {
+    const std::vector<double> base{ 1, 2, 3, 4 };
+    const std::vector<SeedMutation> chain{ { 1, 0.1 }, { 2, 0.2 }, { 3, 0.3 } };
+    SeedGenome genome(base);
+    for(const auto& m : chain) {
+        genome.mutate(m);
+    }
+    REQUIRE(genome.getDepth() == 3);
+    REQUIRE(genome.size() == 4);
+
+    std::vector<double> out;
+    genome.materialize(out);
+    REQUIRE(out == replay(base, chain));
+}
+
+TEST_CASE( "Offspring share the parent chain and diverge", "[seedgenome]" ) {
+    SeedGenome parent(std::vector<double>(5, 0.0));
+    parent.mutate({ 10, 1.0 });
+    auto child = parent;
+    child.mutate({ 11, 1.0 });
+    REQUIRE(child.getId() != parent.getId());
+
+    std::vector<double> p, c;
+    parent.materialize(p);
+    child.materialize(c);
+    REQUIRE(c == replay(p, { { 11, 1.0 } }));
+}
+
+TEST_CASE( "Cached ancestors give the same genome", "[seedgenome]" ) {
+    GenomeCache cache(4);
+    SeedGenome genome(std::vector<double>(8, 0.5));
+    std::vector<double> uncached, cached;
+    for(uint64_t s = 0; s < 20; ++s) {
+        genome.mutate({ s, 0.1 });
+        genome.materialize(cached, &cache);
+    }
+    genome.materialize(uncached);
+    REQUIRE(cached == uncached);
+    REQUIRE(cache.getHits() > 0);
+    REQUIRE(cache.size() <= 4);
+}
+
+TEST_CASE( "Deep chains are collapsed into a new base", "[seedgenome]" ) {
+    const std::vector<double> base{ 0, 0, 0 };
+    std::vector<SeedMutation> chain;
+    SeedGenome genome(base, 4);
+    for(uint64_t s = 0; s < 10; ++s) {
+        chain.push_back({ s, 1.0 });
+        genome.mutate(chain.back());
+        REQUIRE(genome.getDepth() <= 4);
+    }
+    std::vector<double> out;
+    genome.materialize(out);
+    REQUIRE(out == replay(base, chain));
+}
+
+TEST_CASE( "Genome cache evicts the least recently used entry", "[seedgenome]" ) {
+    GenomeCache cache(2);
+    cache.insert(1, { 1.0 });
+    cache.insert(2, { 2.0 });
+    std::vector<double> out;
+    REQUIRE(cache.find(1, out));
+    cache.insert(3, { 3.0 });
+    REQUIRE(!cache.find(2, out));
+    REQUIRE(cache.find(1, out));
+    REQUIRE(out[0] == 1.0);
+    REQUIRE(cache.find(3, out));
+    REQUIRE(out[0] == 3.0);
+}
+
+TEST_CASE( "Threads materialize through one shared cache", "[seedgenome]" ) {
+    GenomeCache cache(3);
+    std::vector<SeedGenome> genomes;
+    std::vector<std::vector<double>> expected(8);
+    for(uint64_t g = 0; g < expected.size(); ++g) {
+        genomes.emplace_back(std::vector<double>(16, static_cast<double>(g)));
+        for(uint64_t s = 0; s < 5; ++s) {
+            genomes.back().mutate({ 10 * g + s, 0.1 });
+        }
+        genomes.back().materialize(expected[g]);
+    }
+
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            std::vector<double> out;
+            for(size_t k = 0; k < 2000; ++k) {
+                const auto g = (k + t) % genomes.size();
+                genomes[g].materialize(out, &cache);
+                mismatches[t] += out != expected[g];
+            }
+        });
+    }
+    for(auto& t : threads) {
+        t.join();
+    }
+    for(const auto m : mismatches) {
+        REQUIRE(m == 0);
+    }
+}
+
+TEST_CASE( "Lineages rebased onto a common ancestor share its base", "[seedgenome]" ) {
+    SeedGenome ancestor(size_t{ 6 }, 8);
+    REQUIRE(ancestor.getBase() == nullptr);
+    std::vector<SeedMutation> chain;
+    for(uint64_t s = 0; s < 4; ++s) {
+        chain.push_back({ s, 1.0 });
+        ancestor.mutate(chain.back());
+    }
+
+    // Both reach the depth limit and rebase onto the ancestor at depth 4
+    auto a = ancestor, b = ancestor;
+    std::vector<SeedMutation> chainA = chain, chainB = chain;
+    for(uint64_t s = 0; s < 5; ++s) {
+        chainA.push_back({ 100 + s, 1.0 });
+        a.mutate(chainA.back());
+        chainB.push_back({ 200 + s, 1.0 });
+        b.mutate(chainB.back());
+    }
+    REQUIRE(a.getDepth() == 5);
+    REQUIRE(a.getBase() != nullptr);
+    REQUIRE(a.getBase() == b.getBase());
+
+    std::vector<double> out;
+    a.materialize(out);
+    REQUIRE(out == replay(std::vector<double>(6, 0.0), chainA));
+    b.materialize(out);
+    REQUIRE(out == replay(std::vector<double>(6, 0.0), chainB));
+}
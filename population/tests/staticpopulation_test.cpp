@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include "population/staticpopulation.h"
+
+#include <cmath>
+#include <random>
+
+namespace {
+
+// Searches for x = 3, no virtual functions involved
+class Scalar
+{
+public:
+    Scalar(double x_, unsigned int seed) : x{ x_ }, engine(seed) {}
+
+    double getFitness() const { return fitness; }
+    void setFitness(double f) { fitness = f; }
+
+    void evaluate() { fitness += std::fabs(x - 3); ++evaluations; }
+    void mutate() { x += std::normal_distribution<double>(0, 0.1)(engine); }
+    void mutateFrom(const Scalar& other) { x = other.x; mutate(); }
+    void refine() { ++refinements; }
+
+    double x;
+    int evaluations{ 0 };
+    int refinements{ 0 };
+
+private:
+    double fitness{ 0 };
+    std::default_random_engine engine;
+};
+
+// Same search, evaluated through the batch hook
+class BatchedScalar : public Scalar
+{
+public:
+    using Scalar::Scalar;
+
+    static void evaluateBatch(BatchedScalar* const* batch, size_t n)
+    {
+        batchSizes.push_back(n);
+        for(size_t i = 0; i < n; ++i) {
+            batch[i]->evaluate();
+        }
+    }
+
+    static std::vector<size_t> batchSizes;
+};
+
+std::vector<size_t> BatchedScalar::batchSizes;
+
+}
+
+TEST_CASE( "Static population ranks and converges", "[staticpopulation]" ) {
+    StaticPopulation<Scalar> pop;
+    for(unsigned int i = 0; i < 20; ++i) {
+        pop.addIndividual(Scalar(-5.0 + i * 0.1, i));
+    }
+    pop.evolve();
+    for(size_t i = 1; i < pop.size(); ++i) {
+        REQUIRE(pop.getIndividual(i - 1).getFitness() <= pop.getIndividual(i).getFitness());
+    }
+
+    for(int gen = 0; gen < 300; ++gen) {
+        pop.evolve();
+    }
+    REQUIRE(pop.getIndividual(0).x == Approx(3).margin(0.05));
+}
+
+TEST_CASE( "Static population refines and re-scores elites", "[staticpopulation]" ) {
+    StaticPopulation<Scalar> pop;
+    for(unsigned int i = 0; i < 10; ++i) {
+        pop.addIndividual(Scalar(i, i));
+    }
+    int fullSets = 0;
+    pop.setSampleSelector([&fullSets](bool fullSet) { fullSets += fullSet; }, 1, 2);
+    pop.setNumRefined(1);
+    pop.evolve();
+
+    REQUIRE(fullSets == 1);
+    int evaluations = 0, refinements = 0;
+    for(size_t i = 0; i < pop.size(); ++i) {
+        evaluations += pop.getIndividual(i).evaluations;
+        refinements += pop.getIndividual(i).refinements;
+    }
+    REQUIRE(evaluations == 10 + 1 + 2);
+    REQUIRE(refinements == 1);
+    REQUIRE(pop.getIndividual(0).x == 3);
+}
+
+TEST_CASE( "Static population uses a static batch hook", "[staticpopulation]" ) {
+    StaticPopulation<BatchedScalar> pop;
+    for(unsigned int i = 0; i < 10; ++i) {
+        pop.addIndividual(BatchedScalar(i, i));
+    }
+    pop.setBatchSize(3);
+    BatchedScalar::batchSizes.clear();
+    pop.evolve();
+
+    REQUIRE(BatchedScalar::batchSizes == std::vector<size_t>{ 3, 3, 3, 1 });
+    REQUIRE(pop.getIndividual(0).x == 3);
+}
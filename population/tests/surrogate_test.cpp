@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+
+#include "population/population.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+TEST_CASE( "Ridge regression recovers a linear model", "[surrogate]" ) {
+    std::mt19937 engine(6);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    RidgeRegression model(1e-6, 1.0);
+    for(int i = 0; i < 200; ++i) {
+        const std::vector<double> x{ 1.0, uniform(engine), uniform(engine) * 1000 };
+        model.add(x, 2 - 3 * x[1] + 0.004 * x[2]);
+    }
+    model.endGeneration();
+    REQUIRE(model.getSamples() == 200);
+    REQUIRE(model.getCoefficients()[0] == Approx(2).margin(1e-3));
+    REQUIRE(model.getCoefficients()[1] == Approx(-3).margin(1e-3));
+    REQUIRE(model.getCoefficients()[2] == Approx(0.004).margin(1e-6));
+    REQUIRE(model.predict({ 1.0, 0.5, 500 }) == Approx(2.5).margin(1e-3));
+}
+
+TEST_CASE( "Rank correlation of agreeing and reversed orders", "[surrogate]" ) {
+    REQUIRE(rankCorrelation({ 1, 2, 3, 4 }, { 10, 20, 30, 40 }) == Approx(1));
+    REQUIRE(rankCorrelation({ 1, 2, 3, 4 }, { 4, 3, 2, 1 }) == Approx(-1));
+}
+
+namespace {
+
+// Fitness is the prior fitness plus the mutation step, which the surrogate sees
+class Stepping : public Individual
+{
+public:
+    explicit Stepping(unsigned int seed) : engine(seed) {}
+
+    void evaluate() override { fitness += value; ++evaluations; }
+    void mutate() override
+    {
+        step = std::uniform_real_distribution<double>(-1, 1)(engine);
+        value += step;
+    }
+    void mutateFrom(const Individual* other) override
+    {
+        value = static_cast<const Stepping*>(other)->value;
+        mutate();
+    }
+    void getFeatures(std::vector<double>& features) const override { features.push_back(step); }
+
+    double value{ 0 };
+    double step{ 0 };
+    static int evaluations;
+
+private:
+    std::default_random_engine engine;
+};
+
+int Stepping::evaluations = 0;
+
+}
+
+TEST_CASE( "Surrogate screening evaluates only the top fraction", "[surrogate]" ) {
+    Population pop;
+    for(unsigned int i = 0; i < 100; ++i) {
+        pop.addIndividual(std::make_unique<Stepping>(i));
+    }
+    pop.setSurrogate(std::make_unique<Surrogate>(0.5, 50));
+
+    pop.evolve();
+    pop.evolve(); // warm-up: every candidate is evaluated and learned from
+    Stepping::evaluations = 0;
+    pop.evolve();
+    // The elite plus half of the 99 candidates
+    REQUIRE(Stepping::evaluations == 1 + 50);
+
+    for(int gen = 0; gen < 10; ++gen) {
+        pop.evolve();
+    }
+    const auto& report = pop.getSurrogate()->getReport();
+    REQUIRE(report.generations == 11);
+    REQUIRE(report.getSavings() == Approx(49.0 / 99));
+    REQUIRE(report.rankCorrelation > 0.9);
+    REQUIRE(pop.getIndividual(0)->getFitness() < -5);
+}
+
+namespace {
+
+// Sorts by fitness, remembering how many individuals it was given
+class CountingRanking : public Ranking
+{
+public:
+    void rank(PopulationVector& individuals, NodeThreadPool*) override
+    {
+        ranked = individuals.size();
+        for(const auto& idv : individuals) {
+            allFinite = allFinite && std::isfinite(idv->getFitness());
+        }
+        std::sort(individuals.begin(), individuals.end(), [](const auto& a, const auto& b) {
+            return a->getFitness() < b->getFitness();
+        });
+    }
+
+    size_t ranked{ 0 };
+    bool allFinite{ true };
+};
+
+}
+
+TEST_CASE( "Rankings never see screened-out individuals", "[surrogate]" ) {
+    Population pop;
+    for(unsigned int i = 0; i < 100; ++i) {
+        pop.addIndividual(std::make_unique<Stepping>(i));
+    }
+    pop.setSurrogate(std::make_unique<Surrogate>(0.5, 50));
+    auto ranking = std::make_unique<CountingRanking>();
+    const auto* counting = ranking.get();
+    pop.setRanking(std::move(ranking));
+
+    pop.evolve();
+    pop.evolve();
+    REQUIRE(counting->ranked == 100);
+    pop.evolve();
+    REQUIRE(counting->ranked == 1 + 50);
+    REQUIRE(counting->allFinite);
+    REQUIRE(std::isfinite(pop.getIndividual(50)->getFitness()));
+    REQUIRE(std::isinf(pop.getIndividual(51)->getFitness()));
+}
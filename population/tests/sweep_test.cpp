@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include "population/sweep.h"
+
+#include <cmath>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// Searches for x = target, starting at x = 0
+class Walker : public Individual
+{
+public:
+    Walker(double target_, double stddev_, unsigned int seed) : target{ target_ }, stddev{ stddev_ }, engine(seed) {}
+
+    void evaluate() override { fitness += std::fabs(x - target); }
+    void mutate() override { x += std::normal_distribution<double>(0, stddev)(engine); }
+    void mutateFrom(const Individual* other) override
+    {
+        x = dynamic_cast<const Walker*>(other)->x;
+        mutate();
+    }
+
+    double x{ 0 };
+
+private:
+    double target;
+    double stddev;
+    std::default_random_engine engine;
+};
+
+}
+
+TEST_CASE( "Sweep grid covers every combination", "[sweep]" ) {
+    SweepSpec spec;
+    spec.addValues("size", { 10, 20 }).addRange("stddev", 0.01, 1, true);
+    const auto points = spec.getGrid(3, 2);
+    REQUIRE(points.size() == 2 * 3 * 2);
+    REQUIRE(points[0].get("size") == 10);
+    REQUIRE(points[0].get("stddev") == Approx(0.01));
+    REQUIRE(points[2].get("stddev") == Approx(0.1));
+    REQUIRE(points[4].get("stddev") == Approx(1));
+    REQUIRE(points[6].get("size") == 20);
+    REQUIRE(points[0].seed != points[1].seed);
+    REQUIRE(points[0].get("missing", -1) == -1);
+}
+
+TEST_CASE( "Random search draws within the spec", "[sweep]" ) {
+    SweepSpec spec;
+    spec.addValues("size", { 10, 20 }).addRange("stddev", 0.5, 2);
+    const auto points = spec.getRandom(50, 3);
+    REQUIRE(points.size() == 50);
+    for(const auto& p : points) {
+        REQUIRE((p.get("size") == 10 || p.get("size") == 20));
+        REQUIRE(p.get("stddev") >= 0.5);
+        REQUIRE(p.get("stddev") <= 2);
+    }
+}
+
+TEST_CASE( "Sweep runner evolves every point", "[sweep]" ) {
+    SweepSpec spec;
+    spec.addValues("size", { 10, 40 }).addValues("target", { 1, 1000 });
+    const auto points = spec.getGrid();
+
+    for(const size_t nThreads : { 1, 3 }) {
+        SweepRunner runner(nThreads);
+        runner.setGenerations(50);
+        runner.setTargetFitness(0.2);
+        const auto results = runner.run(points, [](const SweepPoint& point) {
+            auto population = std::make_unique<Population>();
+            for(size_t i = 0; i < point.get("size"); ++i) {
+                population->addIndividual(std::make_unique<Walker>(point.get("target"), 0.5, point.seed + i));
+            }
+            population->setBatchSize(4);
+            return population;
+        });
+
+        REQUIRE(results.size() == points.size());
+        for(size_t i = 0; i < results.size(); ++i) {
+            REQUIRE(results[i].point.seed == points[i].seed);
+            REQUIRE(results[i].evaluations == 50 * points[i].get("size"));
+            REQUIRE(results[i].seconds >= 0);
+        }
+        // A close target is reached, a far one cannot be within 50 steps
+        REQUIRE(results[0].finalFitness < 0.2);
+        REQUIRE(std::isfinite(results[0].timeToTarget));
+        REQUIRE(results[1].finalFitness > 100);
+        REQUIRE(std::isinf(results[1].timeToTarget));
+
+        std::ostringstream csv;
+        writeSweepCsv(csv, results);
+        std::string header;
+        std::getline(std::istringstream(csv.str()), header);
+        REQUIRE(header == "size,target,seed,final_fitness,time_to_target,evaluations,evaluations_per_second");
+    }
+}
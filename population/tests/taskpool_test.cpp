@@ -0,0 +1,39 @@
+#include <catch2/catch.hpp>
+
+#include "population/taskpool.h"
+
+#include <atomic>
+#include <thread>
+
+TEST_CASE( "Task pool runs every task once", "[taskpool]" ) {
+    for(const size_t nWorkers : { 0, 1, 3 }) {
+        TaskPool pool(nWorkers);
+        REQUIRE(pool.getNumWorkers() == nWorkers);
+        std::vector<int> counts(100, 0);
+        pool.run(counts.size(), [&counts](size_t i) { ++counts[i]; });
+        REQUIRE(counts == std::vector<int>(100, 1));
+        pool.run(0, [&counts](size_t i) { ++counts[i]; });
+    }
+}
+
+TEST_CASE( "Task pool callers share the queue", "[taskpool]" ) {
+    TaskPool pool(1);
+    std::atomic<size_t> total{ 0 };
+    std::atomic<size_t> callersDone{ 0 };
+    const size_t nCallers = 4;
+    std::vector<std::thread> callers;
+    for(size_t c = 0; c < nCallers; ++c) {
+        callers.emplace_back([&]() {
+            for(int round = 0; round < 20; ++round) {
+                pool.run(16, [&total](size_t) { ++total; });
+            }
+            ++callersDone;
+            pool.notify();
+            pool.helpUntil([&]() { return callersDone == nCallers; });
+        });
+    }
+    for(auto& t : callers) {
+        t.join();
+    }
+    REQUIRE(total == nCallers * 20 * 16);
+}
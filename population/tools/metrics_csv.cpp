@@ -0,0 +1,36 @@
+// Exports a metrics log written by MetricsLog to CSV.
+// Usage: metrics_csv <log> [output.csv], writing to stdout without an output path
+
+#include "population/metricslog.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char **argv)
+{
+    if(argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " <log> [output.csv]\n";
+        return 1;
+    }
+
+    try {
+        const auto metrics = readMetricsLog(argv[1]);
+        if(argc == 2) {
+            writeMetricsCsv(std::cout, metrics);
+            return 0;
+        }
+        std::ofstream csv(argv[2]);
+        writeMetricsCsv(csv, metrics);
+        if(!csv) {
+            throw std::runtime_error(std::string("error writing ") + argv[2]);
+        }
+        std::cerr << "wrote " << metrics.size() << " generations to " << argv[2] << "\n";
+    }
+    catch(const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Non-dominated sorting and crowding distance on random objectives at the
+// population sizes of large multi-objective runs. Usage: nsga_bench [max n]
+
+#include "population/multiobjective.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Textbook NSGA-II sort: domination counts and dominated sets, O(M N^2)
+std::vector<size_t> quadraticSort(const std::vector<double>& objectives, size_t n, size_t m)
+{
+    std::vector<std::vector<size_t>> dominated(n);
+    std::vector<size_t> counts(n, 0);
+    for(size_t i = 0; i < n; ++i) {
+        for(size_t j = i + 1; j < n; ++j) {
+            if(dominates(&objectives[i * m], &objectives[j * m], m)) {
+                dominated[i].push_back(j);
+                ++counts[j];
+            }
+            else if(dominates(&objectives[j * m], &objectives[i * m], m)) {
+                dominated[j].push_back(i);
+                ++counts[i];
+            }
+        }
+    }
+    std::vector<size_t> fronts(n, 0);
+    std::vector<size_t> current;
+    for(size_t i = 0; i < n; ++i) {
+        if(counts[i] == 0) {
+            current.push_back(i);
+        }
+    }
+    for(size_t front = 0; !current.empty(); ++front) {
+        std::vector<size_t> next;
+        for(const auto i : current) {
+            fronts[i] = front;
+            for(const auto j : dominated[i]) {
+                if(--counts[j] == 0) {
+                    next.push_back(j);
+                }
+            }
+        }
+        current.swap(next);
+    }
+    return fronts;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    const size_t maxN = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t quadraticLimit = 10000;
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    for(size_t m = 2; m <= 3; ++m) {
+        for(size_t n = 1000; n <= maxN; n *= 10) {
+            std::vector<double> objectives(n * m);
+            for(auto& v : objectives) {
+                v = uniform(engine);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            const auto fronts = nonDominatedSort(objectives.data(), n, m);
+            const auto sortMs = millisecondsSince(start);
+
+            std::vector<std::vector<size_t>> members;
+            for(size_t i = 0; i < n; ++i) {
+                if(fronts[i] >= members.size()) {
+                    members.resize(fronts[i] + 1);
+                }
+                members[fronts[i]].push_back(i);
+            }
+            start = std::chrono::steady_clock::now();
+            for(const auto& front : members) {
+                crowdingDistances(objectives.data(), m, front);
+            }
+            const auto crowdingMs = millisecondsSince(start);
+
+            std::cout << "m=" << m << " n=" << n << ": " << members.size() << " fronts, sort "
+                      << sortMs << " ms, crowding " << crowdingMs << " ms";
+            if(n <= quadraticLimit) {
+                start = std::chrono::steady_clock::now();
+                const auto reference = quadraticSort(objectives, n, m);
+                std::cout << ", O(MN^2) sort " << millisecondsSince(start) << " ms"
+                          << (reference == fronts ? "" : " MISMATCH");
+            }
+            std::cout << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Evaluation throughput of a memory-bound population on NUMA node partitions:
+// individuals first-touched by the node that evaluates them, against individuals
+// spread round robin over all nodes, so that most accesses on a multi-socket
+// machine are remote. Usage: numa_bench [individuals] [genome size] [generations]
+
+#include "population/population.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace {
+
+// Evaluation streams through the whole genome, mutation is free
+class StreamingIndividual : public Individual
+{
+public:
+    explicit StreamingIndividual(size_t size) : genome(size, 1.0) {}
+
+    void evaluate() override
+    {
+        double sum = 0;
+        for(const auto g : genome) {
+            sum += g * g;
+        }
+        fitness += std::sqrt(sum);
+    }
+    void mutate() override {}
+    void mutateFrom(const Individual*) override {}
+
+    std::unique_ptr<Individual> clone() const override { return std::make_unique<StreamingIndividual>(*this); }
+
+private:
+    std::vector<double> genome;
+};
+
+double run(const std::vector<NumaNode>& nodes, size_t nIndividuals, size_t genomeSize, size_t generations,
+           bool firstTouch)
+{
+    Population pop;
+    std::vector<std::unique_ptr<Individual>> created(nIndividuals);
+    if(firstTouch) {
+        for(auto& idv : created) {
+            idv = std::make_unique<StreamingIndividual>(genomeSize);
+        }
+    }
+    else {
+        // Individual i is allocated on node i % nodes, wherever its partition ends up
+        NodeThreadPool allocator(nodes, 1);
+        allocator.run([&](size_t node, size_t, size_t) {
+            for(size_t i = node; i < nIndividuals; i += nodes.size()) {
+                created[i] = std::make_unique<StreamingIndividual>(genomeSize);
+            }
+        });
+    }
+    for(auto& idv : created) {
+        pop.addIndividual(std::move(idv));
+    }
+    pop.setNumaNodes(nodes, 0, firstTouch);
+    pop.evolve();
+
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t gen = 0; gen < generations; ++gen) {
+        pop.evolve();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count() / generations;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    const size_t nIndividuals = argc > 1 ? std::stoul(argv[1]) : 256;
+    const size_t genomeSize = argc > 2 ? std::stoul(argv[2]) : 1 << 16;
+    const size_t generations = argc > 3 ? std::stoul(argv[3]) : 20;
+
+    const auto nodes = getNumaNodes();
+    std::cout << nodes.size() << " NUMA node(s):";
+    for(const auto& node : nodes) {
+        std::cout << " node" << node.id << "=" << node.cpus.size() << " cpus";
+    }
+    std::cout << "\n" << nIndividuals << " individuals of " << genomeSize * sizeof(double) / 1024
+              << " KiB, " << generations << " generations\n";
+
+    const auto local = run(nodes, nIndividuals, genomeSize, generations, true);
+    const auto spread = run(nodes, nIndividuals, genomeSize, generations, false);
+    std::cout << "first touch per node: " << local << " ms/gen\n"
+              << "round robin over nodes: " << spread << " ms/gen\n"
+              << "speedup: " << spread / local << "\n";
+    if(nodes.size() == 1) {
+        std::cout << "(single node: both layouts are local)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Ring of the most recent completed scopes of one thread. Only the owning thread
+// pushes, without locks; others may take snapshots at any time.
+class TraceBuffer
+{
+public:
+    struct Event
+    {
+        const char* name;
+        uint64_t begin; // nanoseconds since the tracer started
+        uint64_t end;
+    };
+
+    // capacity is rounded up to a power of two
+    explicit TraceBuffer(size_t capacity = size_t{1} << 16);
+
+    // Overwrites the oldest event once full. name must outlive the buffer, e.g. a literal.
+    void push(const char* name, uint64_t begin, uint64_t end);
+
+    // Appends the events still held to out, oldest first. Events the owner
+    // overwrites meanwhile are left out rather than returned torn.
+    void snapshot(std::vector<Event>& out) const;
+
+    size_t getCapacity() const { return mask + 1; }
+    // Events pushed so far, including overwritten ones
+    uint64_t getPushed() const { return head.load(std::memory_order_acquire); }
+
+private:
+    struct Slot
+    {
+        std::atomic<const char*> name;
+        std::atomic<uint64_t> begin;
+        std::atomic<uint64_t> end;
+    };
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head{ 0 };
+    // One past the index of the slot last written or being written
+    std::atomic<uint64_t> writing{ 0 };
+};
+
+// Process-wide recorder with one TraceBuffer per thread that records, kept after
+// the thread exits. Dumps to the Chrome trace event format, which chrome://tracing
+// and Perfetto load.
+class Tracer
+{
+public:
+    static Tracer& get();
+
+    uint64_t now() const;
+
+    // On the calling thread's buffer
+    void record(const char* name, uint64_t begin, uint64_t end);
+
+    // Labels the calling thread in the timeline
+    void setThreadName(const std::string& name);
+
+    void writeChromeTrace(std::ostream& os) const;
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    Tracer();
+
+    struct Thread
+    {
+        size_t id;
+        std::string name;
+        TraceBuffer buffer;
+    };
+
+    Thread& local();
+
+    const uint64_t epoch;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Thread>> threads;
+};
+
+// Records its lifetime as one event
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name_) : name{ name_ }, begin{ Tracer::get().now() } {}
+    ~TraceScope() { Tracer::get().record(name, begin, Tracer::get().now()); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+// TRACE_SCOPE("name") records the rest of the enclosing block; name must be a
+// literal. Unless built with EVOLVENN_TRACE, the macros expand to nothing.
+#if defined(EVOLVENN_TRACE) && EVOLVENN_TRACE
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) const TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Tracer::get().setThreadName(name)
+#define TRACE_WRITE(path) Tracer::get().writeChromeTrace(path)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_WRITE(path) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,164 @@
+#include "tracing/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace {
+
+uint64_t steadyNanoseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void writeJsonString(std::ostream& os, const char* s)
+{
+    os << '"';
+    for(; *s; ++s) {
+        if(*s == '"' || *s == '\\') {
+            os << '\\' << *s;
+        }
+        else if(static_cast<unsigned char>(*s) >= 0x20) {
+            os << *s;
+        }
+    }
+    os << '"';
+}
+
+// Chrome traces count in microseconds
+void writeMicroseconds(std::ostream& os, uint64_t nanoseconds)
+{
+    const auto fraction = nanoseconds % 1000;
+    os << nanoseconds / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
+
+}
+
+TraceBuffer::TraceBuffer(size_t capacity)
+{
+    size_t size = 1;
+    while(size < capacity) {
+        size *= 2;
+    }
+    mask = size - 1;
+    slots.reset(new Slot[size]);
+}
+
+void TraceBuffer::push(const char* name, uint64_t begin, uint64_t end)
+{
+    // Announce the slot as being rewritten before touching it, like a seqlock
+    const auto index = head.load(std::memory_order_relaxed);
+    writing.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& slot = slots[index & mask];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    head.store(index + 1, std::memory_order_release);
+}
+
+void TraceBuffer::snapshot(std::vector<Event>& out) const
+{
+    const auto last = head.load(std::memory_order_acquire);
+    const auto capacity = getCapacity();
+    const auto first = last > capacity ? last - capacity : 0;
+    const auto offset = out.size();
+    for(auto index = first; index < last; ++index) {
+        const auto& slot = slots[index & mask];
+        out.push_back(Event{ slot.name.load(std::memory_order_relaxed),
+                             slot.begin.load(std::memory_order_relaxed),
+                             slot.end.load(std::memory_order_relaxed) });
+    }
+
+    // Slots rewritten since, or being rewritten, may be torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto written = writing.load(std::memory_order_relaxed);
+    const auto firstIntact = written > capacity ? written - capacity : 0;
+    if(firstIntact > first) {
+        const auto torn = std::min<uint64_t>(firstIntact - first, last - first);
+        out.erase(out.begin() + offset, out.begin() + offset + torn);
+    }
+}
+
+Tracer& Tracer::get()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : epoch{ steadyNanoseconds() }
+{
+}
+
+uint64_t Tracer::now() const
+{
+    return steadyNanoseconds() - epoch;
+}
+
+Tracer::Thread& Tracer::local()
+{
+    thread_local Thread* thread = nullptr;
+    if(!thread) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(std::make_unique<Thread>());
+        thread = threads.back().get();
+        thread->id = threads.size();
+    }
+    return *thread;
+}
+
+void Tracer::record(const char* name, uint64_t begin, uint64_t end)
+{
+    local().buffer.push(name, begin, end);
+}
+
+void Tracer::setThreadName(const std::string& name)
+{
+    auto& thread = local();
+    std::lock_guard<std::mutex> lock(mutex);
+    thread.name = name;
+}
+
+void Tracer::writeChromeTrace(std::ostream& os) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    const auto separate = [&os, &first]() {
+        os << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    std::vector<TraceBuffer::Event> events;
+    for(const auto& thread : threads) {
+        if(!thread->name.empty()) {
+            separate();
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"name\":";
+            writeJsonString(os, thread->name.c_str());
+            os << "}}";
+        }
+        events.clear();
+        thread->buffer.snapshot(events);
+        // Complete events, each a scope's begin and duration
+        for(const auto& e : events) {
+            separate();
+            os << "{\"name\":";
+            writeJsonString(os, e.name);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id << ",\"ts\":";
+            writeMicroseconds(os, e.begin);
+            os << ",\"dur\":";
+            writeMicroseconds(os, e.end - e.begin);
+            os << "}";
+        }
+    }
+    os << "\n]}\n";
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path);
+    writeChromeTrace(file);
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+
+#include "tracing/trace.h"
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+TEST_CASE( "Trace buffer keeps the newest events", "[trace]" ) {
+    TraceBuffer buffer(5);
+    REQUIRE(buffer.getCapacity() == 8);
+
+    std::vector<TraceBuffer::Event> events;
+    buffer.snapshot(events);
+    REQUIRE(events.empty());
+
+    for(uint64_t i = 0; i < 3; ++i) {
+        buffer.push("a", i, i + 1);
+    }
+    buffer.snapshot(events);
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0].begin == 0);
+
+    // Once full, the slot the owner would rewrite next is still intact
+    for(uint64_t i = 3; i < 20; ++i) {
+        buffer.push("a", i, i + 1);
+    }
+    events.clear();
+    buffer.snapshot(events);
+    REQUIRE(buffer.getPushed() == 20);
+    REQUIRE(events.size() == 8);
+    for(size_t k = 0; k < events.size(); ++k) {
+        REQUIRE(events[k].begin == 12 + k);
+    }
+}
+
+TEST_CASE( "Trace buffer snapshots are consistent while recording", "[trace]" ) {
+    TraceBuffer buffer(64);
+    std::atomic<bool> done{ false };
+    std::thread writer([&]() {
+        for(uint64_t i = 0; i < 200000; ++i) {
+            buffer.push("w", i, 2 * i);
+        }
+        done = true;
+    });
+    std::vector<TraceBuffer::Event> events;
+    while(!done) {
+        events.clear();
+        buffer.snapshot(events);
+        for(size_t k = 0; k < events.size(); ++k) {
+            if(events[k].end != 2 * events[k].begin || (k && events[k].begin != events[k - 1].begin + 1)) {
+                FAIL("torn or out of order event");
+            }
+        }
+    }
+    writer.join();
+}
+
+TEST_CASE( "Tracer writes Chrome trace events per thread", "[trace]" ) {
+    auto& tracer = Tracer::get();
+    tracer.setThreadName("main \"test\"");
+    {
+        const TraceScope scope("outer");
+        const TraceScope inner("inner");
+    }
+    std::thread other([]() {
+        Tracer::get().setThreadName("other");
+        Tracer::get().record("fixed", 1500, 4250);
+    });
+    other.join();
+
+    std::ostringstream json;
+    tracer.writeChromeTrace(json);
+    const auto text = json.str();
+    REQUIRE(text.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    REQUIRE(text.find("\"name\":\"outer\",\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(text.find("\"name\":\"inner\"") != std::string::npos);
+    REQUIRE(text.find("\"args\":{\"name\":\"main \\\"test\\\"\"}") != std::string::npos);
+    REQUIRE(text.find("\"name\":\"fixed\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":1.500,\"dur\":2.750}") != std::string::npos);
+    REQUIRE(text.substr(text.size() - 4) == "\n]}\n");
+}